@@ -1,6 +1,7 @@
 #ifndef BINARY_SERIALIZATION_H
 #define BINARY_SERIALIZATION_H
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <cstdint>
@@ -32,29 +33,61 @@ inline void writeBinary(std::ofstream& out, const std::string& str) {
 
 // Чтение примитивных типов
 inline uint32_t readUint32(std::ifstream& in) {
-    uint32_t value;
+    uint32_t value = 0;
     in.read(reinterpret_cast<char*>(&value), sizeof(value));
     return value;
 }
 
 inline size_t readSize(std::ifstream& in) {
-    uint32_t value;
+    uint32_t value = 0;
     in.read(reinterpret_cast<char*>(&value), sizeof(value));
     return static_cast<size_t>(value);
 }
 
 inline bool readBool(std::ifstream& in) {
-    uint8_t value;
+    uint8_t value = 0;
     in.read(reinterpret_cast<char*>(&value), sizeof(value));
     return value != 0;
 }
 
-// Чтение строки
+// Элементов из заголовка снимка, под которые память выделяется заранее.
+// Число в заголовке не проверено: сверх этого контейнер растёт по мере
+// чтения, и испорченный заголовок не приводит к огромному выделению
+constexpr size_t MAX_PRESIZED_ITEMS = size_t(1) << 16;
+
+// Чтение строки. Длина тоже берётся из файла, поэтому данные читаются
+// порциями: у обрезанного снимка чтение упадёт раньше, чем вырастет строка
 inline std::string readString(std::ifstream& in) {
+    static constexpr size_t CHUNK = size_t(1) << 16;
     uint32_t length = readUint32(in);
-    std::string str(length, '\0');
-    in.read(&str[0], length);
+    std::string str;
+    while (in && str.size() < length) {
+        size_t offset = str.size();
+        size_t chunk = std::min<size_t>(length - offset, CHUNK);
+        str.resize(offset + chunk);
+        in.read(&str[offset], static_cast<std::streamsize>(chunk));
+    }
     return str;
 }
 
+// Запись и чтение значения шаблонного контейнера: POD-типы побайтно,
+// строки - длина + данные
+template<typename T>
+inline void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void writeValue(std::ofstream& out, const std::string& value) {
+    writeBinary(out, value);
+}
+
+template<typename T>
+inline void readValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+inline void readValue(std::ifstream& in, std::string& value) {
+    value = readString(in);
+}
+
 #endif
\ No newline at end of file
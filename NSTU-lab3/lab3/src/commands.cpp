@@ -6,6 +6,9 @@
 #include <vector>
 #include <algorithm>
 #include <tuple>
+#include <string_view>
+#include <cctype>
+#include <limits>
 
 using namespace std;
 
@@ -17,7 +20,10 @@ map<string, Stack<string>> stacks;
 map<string, Queue<string>> queues;
 map<string, HashMap<string, string>> hashmaps;
 map<string, Set<string>> sets;
+map<string, RoaringSet<uint32_t>> roaringSets;
 map<string, AVLTree<string>> trees;
+map<string, CuckooHashMap<string, string>> cuckoos;
+map<string, BloomFilter<string>> blooms;
 
 // Парсинг типа контейнера
 ContainerType parseContainerType(const string& type) {
@@ -29,6 +35,8 @@ ContainerType parseContainerType(const string& type) {
     if (type == "HASHMAP" || type == "H") return HASHMAP;
     if (type == "SET" || type == "E") return SET;
     if (type == "TREE" || type == "T") return AVLTREE;
+    if (type == "CUCKOO" || type == "C") return CUCKOO;
+    if (type == "BLOOM" || type == "B") return BLOOM;
     throw runtime_error("Неизвестный тип контейнера: " + type);
 }
 
@@ -63,8 +71,9 @@ void saveAllContainers(const string& filePath) {
         // HashMap не имеет итератора, поэтому пока сохраняем пустой объект
     }
     
+    // Деревья - по возрастанию, загрузка построит их без поворотов
     for (const auto& [name, tree] : trees) {
-        j["trees"][name] = json::array();
+        j["trees"][name] = vector<string>(tree.begin(), tree.end());
     }
     
     // Записываем в файл
@@ -137,6 +146,18 @@ void loadAllContainers(const string& filePath) {
         }
     }
     
+    // Загружаем деревья: значения по возрастанию - построение за O(n)
+    if (j.contains("trees")) {
+        for (auto it = j["trees"].begin(); it != j["trees"].end(); ++it) {
+            string name = it.key();
+            trees.emplace(std::piecewise_construct,
+                         std::forward_as_tuple(name),
+                         std::forward_as_tuple());
+            
+            trees.at(name).bulkLoad(it.value().get<vector<string>>());
+        }
+    }
+    
     cout << "✓ Контейнеры загружены из " << filePath << endl;
 }
 
@@ -202,6 +223,27 @@ void saveAllContainersBinary(const string& filePath) {
         tree.saveToBinary(out);
     }
     
+    // Кукушкины таблицы - последняя секция: файлы старых версий
+    // заканчиваются перед ней
+    count = static_cast<uint32_t>(cuckoos.size());
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& [name, map] : cuckoos) {
+        uint32_t nameLen = static_cast<uint32_t>(name.length());
+        out.write(reinterpret_cast<const char*>(&nameLen), sizeof(nameLen));
+        out.write(name.c_str(), nameLen);
+        map.saveToBinary(out);
+    }
+    
+    // Фильтры Блума - после кукушкиных таблиц, по тому же принципу
+    count = static_cast<uint32_t>(blooms.size());
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& [name, filter] : blooms) {
+        uint32_t nameLen = static_cast<uint32_t>(name.length());
+        out.write(reinterpret_cast<const char*>(&nameLen), sizeof(nameLen));
+        out.write(name.c_str(), nameLen);
+        filter.saveToBinary(out);
+    }
+    
     out.close();
     cout << "✓ Все контейнеры сохранены в бинарный файл " << filePath << endl;
 }
@@ -219,6 +261,8 @@ void loadAllContainersBinary(const string& filePath) {
     queues.clear();
     hashmaps.clear();
     trees.clear();
+    cuckoos.clear();
+    blooms.clear();
     
     uint32_t count;
     
@@ -287,45 +331,183 @@ void loadAllContainersBinary(const string& filePath) {
         trees.emplace(name, std::move(tree));
     }
     
+    // Кукушкины таблицы (в файлах старых версий секции нет)
+    if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+        count = 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t nameLen;
+        in.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
+        string name(nameLen, '\0');
+        in.read(&name[0], nameLen);
+        
+        CuckooHashMap<string, string> map;
+        map.loadFromBinary(in);
+        cuckoos.emplace(name, std::move(map));
+    }
+    
+    // Фильтры Блума (в файлах старых версий секции нет)
+    if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+        count = 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t nameLen;
+        in.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
+        string name(nameLen, '\0');
+        in.read(&name[0], nameLen);
+        
+        BloomFilter<string> filter;
+        filter.loadFromBinary(in);
+        blooms.emplace(name, std::move(filter));
+    }
+    
     in.close();
     cout << "✓ Контейнеры загружены из бинарного файла " << filePath << endl;
 }
 
+// Разбиение строки на слова без копирования: элементы указывают
+// в исходную строку и действительны, пока она жива
+vector<string_view> splitWords(string_view text) {
+    vector<string_view> words;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) pos++;
+        size_t start = pos;
+        while (pos < text.size() && !isspace(static_cast<unsigned char>(text[pos]))) pos++;
+        if (pos > start) words.push_back(text.substr(start, pos - start));
+    }
+    return words;
+}
+
 // Парсинг команды нового формата: MPUSH, SPOP, QPEEK, HPUT и т.д.
+// Операция и аргументы - представления буфера команды: поиск по ключу
+// (HGET, HCONTAINS, ECONTAINS, TSEARCH) не создаёт временных строк
 struct ParsedCommand {
-    char containerPrefix;     // M, S, Q, H, T, E, F, L
-    string operation;         // PUSH, POP, GET и т.д.
+    char containerPrefix;     // M, S, Q, H, T, E, F, L, C, B
+    string_view operation;    // PUSH, POP, GET и т.д.
     string containerName;
-    vector<string> args;
+    vector<string_view> args;
     bool isValid = false;
 };
 
-ParsedCommand parseNewFormat(const string& cmd, istringstream& iss) {
+ParsedCommand parseNewFormat(string_view command) {
     ParsedCommand result;
+    vector<string_view> words = splitWords(command);
     
-    if (cmd.length() < 2) {
+    if (words.size() < 2 || words[0].length() < 2) {
         return result;
     }
     
     // Первый символ - префикс контейнера
-    result.containerPrefix = cmd[0];
+    result.containerPrefix = words[0][0];
     
     // Остальное - операция
-    result.operation = cmd.substr(1);
+    result.operation = words[0].substr(1);
     
-    // Читаем имя контейнера
-    iss >> result.containerName;
+    // Имя контейнера и остальные аргументы
+    result.containerName = string(words[1]);
+    result.args.assign(words.begin() + 2, words.end());
     
-    // Читаем остальные аргументы
-    string arg;
-    while (iss >> arg) {
-        result.args.push_back(arg);
+    result.isValid = true;
+    return result;
+}
+
+// Алгебра множеств над несколькими входами одной кодировки: UNION, INTER или DIFF
+template<typename SetType>
+SetType combineSets(const map<string, SetType>& registry, string_view operation,
+                    const vector<string_view>& names) {
+    vector<const SetType*> inputs;
+    for (string_view name : names) {
+        auto it = registry.find(string(name));
+        if (it == registry.end()) {
+            throw runtime_error("Множество не найдено или в другой кодировке: " + string(name));
+        }
+        inputs.push_back(&it->second);
+    }
+    if (operation == "INTER") {
+        // С меньших множеств промежуточный результат сразу мал
+        sort(inputs.begin(), inputs.end(), [](const SetType* a, const SetType* b) {
+            return a->size() < b->size();
+        });
     }
     
-    result.isValid = !result.containerName.empty();
+    SetType result = *inputs[0];
+    for (size_t i = 1; i < inputs.size(); i++) {
+        if (operation == "UNION") {
+            result = SetType::unionOf(result, *inputs[i]);
+        } else if (operation == "INTER") {
+            result = SetType::intersectionOf(result, *inputs[i]);
+        } else {
+            result = SetType::differenceOf(result, *inputs[i]);
+        }
+    }
     return result;
 }
 
+// Элемент ROARING-множества - целое без знака в 32 битах
+uint32_t parseRoaringMember(string_view text) {
+    size_t parsed = 0;
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(string(text), &parsed);
+    } catch (const std::exception&) {
+        parsed = 0;
+    }
+    if (text.empty() || text[0] == '-' || parsed != text.size() ||
+        value > std::numeric_limits<uint32_t>::max()) {
+        throw runtime_error("Элемент ROARING-множества должен быть целым от 0 до 4294967295: " + string(text));
+    }
+    return static_cast<uint32_t>(value);
+}
+
+void processRoaringSet(RoaringSet<uint32_t>& set, const string& name, string_view operation,
+                       const vector<string_view>& args) {
+    if (operation == "ADD" || operation == "PUSH") {
+        if (args.empty()) throw runtime_error("EADD требует значение");
+        set.add(parseRoaringMember(args[0]));
+        cout << "✓ Добавлено в множество: " << args[0] << endl;
+    }
+    else if (operation == "ADDRANGE") {
+        if (args.size() < 2) throw runtime_error("EADDRANGE требует начало и конец отрезка");
+        set.addRange(parseRoaringMember(args[0]), parseRoaringMember(args[1]));
+        cout << "✓ Добавлен отрезок [" << args[0] << ", " << args[1] << "]" << endl;
+    }
+    else if (operation == "CONTAINS") {
+        if (args.empty()) throw runtime_error("ECONTAINS требует значение");
+        cout << (set.contains(parseRoaringMember(args[0])) ? "Да" : "Нет") << endl;
+    }
+    else if (operation == "REMOVE") {
+        if (args.empty()) throw runtime_error("EREMOVE требует значение");
+        set.remove(parseRoaringMember(args[0]));
+        cout << "✓ Удалено: " << args[0] << endl;
+    }
+    else if (operation == "SIZE") {
+        cout << "Размер: " << set.size() << endl;
+    }
+    else if (operation == "STATS") {
+        cout << "Размер: " << set.size() << ", кодировка: ROARING, память: "
+             << set.memoryUsage() << " байт" << endl;
+    }
+    else if (operation == "PRINT") {
+        set.print();
+        cout << endl;
+    }
+    else if (operation == "CLEAR") {
+        set.clear();
+        cout << "✓ Множество очищено" << endl;
+    }
+    else if (operation == "UNION" || operation == "INTER" || operation == "DIFF") {
+        if (args.empty()) throw runtime_error("E" + string(operation) + " требует минимум два множества");
+        vector<string_view> names{name};
+        names.insert(names.end(), args.begin(), args.end());
+        combineSets(roaringSets, operation, names).print();
+        cout << endl;
+    }
+    else {
+        throw runtime_error("Неизвестная операция для SET: " + string(operation));
+    }
+}
+
 // Обработка команд
 void processCommand(const string& command) {
     istringstream iss(command);
@@ -432,20 +614,44 @@ void processCommand(const string& command) {
                 break;
             case HASHMAP:
                 if (hashmaps.find(containerName) == hashmaps.end()) {
+                    // CREATE HASHMAP <ИМЯ> [ЁМКОСТЬ] [МАКС_ЗАПОЛНЕННОСТЬ] [INCREMENTAL]
+                    size_t initialCapacity = 101;
+                    double maxLoadFactor = 0.75;
+                    auto rehashMode = HashMap<string, string>::FULL_REHASH;
+                    int positional = 0;
+                    string arg;
+                    while (iss >> arg) {
+                        if (arg == "INCREMENTAL") {
+                            rehashMode = HashMap<string, string>::INCREMENTAL_REHASH;
+                        } else if (positional++ == 0) {
+                            initialCapacity = std::stoul(arg);
+                        } else {
+                            maxLoadFactor = std::stod(arg);
+                        }
+                    }
                     hashmaps.emplace(std::piecewise_construct,
                                     std::forward_as_tuple(containerName),
-                                    std::forward_as_tuple());
+                                    std::forward_as_tuple(initialCapacity, maxLoadFactor, rehashMode));
                     cout << "✓ Создана пустая хеш-таблица '" << containerName << "'" << endl;
                 } else {
                     cout << "⚠ Хеш-таблица '" << containerName << "' уже существует" << endl;
                 }
                 break;
             case SET:
-                if (sets.find(containerName) == sets.end()) {
-                    sets.emplace(std::piecewise_construct,
-                                std::forward_as_tuple(containerName),
-                                std::forward_as_tuple());
-                    cout << "✓ Создано пустое множество '" << containerName << "'" << endl;
+                if (sets.find(containerName) == sets.end() && roaringSets.find(containerName) == roaringSets.end()) {
+                    // CREATE SET <ИМЯ> [HASH|ROARING]
+                    string encoding = "HASH";
+                    iss >> encoding;
+                    if (encoding == "ROARING") {
+                        roaringSets.emplace(containerName, RoaringSet<uint32_t>());
+                    } else if (encoding == "HASH") {
+                        sets.emplace(std::piecewise_construct,
+                                    std::forward_as_tuple(containerName),
+                                    std::forward_as_tuple());
+                    } else {
+                        throw runtime_error("Неизвестная кодировка множества: " + encoding);
+                    }
+                    cout << "✓ Создано пустое множество '" << containerName << "' (" << encoding << ")" << endl;
                 } else {
                     cout << "⚠ Множество '" << containerName << "' уже существует" << endl;
                 }
@@ -460,6 +666,42 @@ void processCommand(const string& command) {
                     cout << "⚠ Дерево '" << containerName << "' уже существует" << endl;
                 }
                 break;
+            case CUCKOO:
+                if (cuckoos.find(containerName) == cuckoos.end()) {
+                    // CREATE CUCKOO <ИМЯ> [ЁМКОСТЬ]
+                    string arg;
+                    size_t initialCapacity = 101;
+                    if (iss >> arg) {
+                        initialCapacity = std::stoul(arg);
+                    }
+                    cuckoos.emplace(std::piecewise_construct,
+                                   std::forward_as_tuple(containerName),
+                                   std::forward_as_tuple(initialCapacity));
+                    cout << "✓ Создана пустая кукушкина хеш-таблица '" << containerName << "'" << endl;
+                } else {
+                    cout << "⚠ Кукушкина хеш-таблица '" << containerName << "' уже существует" << endl;
+                }
+                break;
+            case BLOOM:
+                if (blooms.find(containerName) == blooms.end()) {
+                    // CREATE BLOOM <ИМЯ> [ОЖИДАЕМО_КЛЮЧЕЙ] [ДОЛЯ_ЛОЖНЫХ]
+                    size_t expectedItems = 1000;
+                    double targetRate = 0.01;
+                    string arg;
+                    if (iss >> arg) {
+                        expectedItems = std::stoul(arg);
+                    }
+                    if (iss >> arg) {
+                        targetRate = std::stod(arg);
+                    }
+                    blooms.emplace(std::piecewise_construct,
+                                  std::forward_as_tuple(containerName),
+                                  std::forward_as_tuple(expectedItems, targetRate));
+                    cout << "✓ Создан пустой фильтр Блума '" << containerName << "'" << endl;
+                } else {
+                    cout << "⚠ Фильтр Блума '" << containerName << "' уже существует" << endl;
+                }
+                break;
         }
         return;
     }
@@ -519,7 +761,7 @@ void processCommand(const string& command) {
                 }
                 break;
             case SET:
-                if (sets.erase(containerName) > 0) {
+                if (sets.erase(containerName) + roaringSets.erase(containerName) > 0) {
                     cout << "✓ Множество '" << containerName << "' удалено" << endl;
                 } else {
                     cout << "⚠ Множество '" << containerName << "' не найдено" << endl;
@@ -532,6 +774,20 @@ void processCommand(const string& command) {
                     cout << "⚠ Дерево '" << containerName << "' не найдено" << endl;
                 }
                 break;
+            case CUCKOO:
+                if (cuckoos.erase(containerName) > 0) {
+                    cout << "✓ Кукушкина хеш-таблица '" << containerName << "' удалена" << endl;
+                } else {
+                    cout << "⚠ Кукушкина хеш-таблица '" << containerName << "' не найдена" << endl;
+                }
+                break;
+            case BLOOM:
+                if (blooms.erase(containerName) > 0) {
+                    cout << "✓ Фильтр Блума '" << containerName << "' удалён" << endl;
+                } else {
+                    cout << "⚠ Фильтр Блума '" << containerName << "' не найден" << endl;
+                }
+                break;
         }
         return;
     }
@@ -586,11 +842,14 @@ void processCommand(const string& command) {
             cout << endl;
         }
         
-        if (!sets.empty()) {
-            cout << "🎯 Множества (" << sets.size() << "):" << endl;
+        if (!sets.empty() || !roaringSets.empty()) {
+            cout << "🎯 Множества (" << sets.size() + roaringSets.size() << "):" << endl;
             for (const auto& [name, set] : sets) {
                 cout << "  - " << name << " (размер: " << set.size() << ")" << endl;
             }
+            for (const auto& [name, set] : roaringSets) {
+                cout << "  - " << name << " (размер: " << set.size() << ", ROARING)" << endl;
+            }
             cout << endl;
         }
         
@@ -602,9 +861,26 @@ void processCommand(const string& command) {
             cout << endl;
         }
         
+        if (!cuckoos.empty()) {
+            cout << "🐦 Кукушкины хеш-таблицы (" << cuckoos.size() << "):" << endl;
+            for (const auto& [name, map] : cuckoos) {
+                cout << "  - " << name << " (размер: " << map.size() << ")" << endl;
+            }
+            cout << endl;
+        }
+        
+        if (!blooms.empty()) {
+            cout << "🌸 Фильтры Блума (" << blooms.size() << "):" << endl;
+            for (const auto& [name, filter] : blooms) {
+                cout << "  - " << name << " (добавлений: " << filter.size() << ")" << endl;
+            }
+            cout << endl;
+        }
+        
         size_t total = arrays.size() + singleLists.size() + doubleLists.size() + 
                       stacks.size() + queues.size() + hashmaps.size() + 
-                      sets.size() + trees.size();
+                      sets.size() + roaringSets.size() + trees.size() + cuckoos.size() +
+                      blooms.size();
         
         if (total == 0) {
             cout << "  (Нет созданных контейнеров)" << endl;
@@ -613,7 +889,7 @@ void processCommand(const string& command) {
     }
     
     // Парсим команду нового формата
-    ParsedCommand parsed = parseNewFormat(cmd, iss);
+    ParsedCommand parsed = parseNewFormat(command);
     
     if (!parsed.isValid) {
         throw runtime_error("Invalid command format. Use: <PREFIX><OPERATION> <NAME> [ARGS]\nExample: MPUSH myarray value");
@@ -629,13 +905,15 @@ void processCommand(const string& command) {
     else if (parsed.containerPrefix == 'E') type = SET;
     else if (parsed.containerPrefix == 'F') type = SINGLE_LIST;
     else if (parsed.containerPrefix == 'L') type = DOUBLE_LIST;
+    else if (parsed.containerPrefix == 'C') type = CUCKOO;
+    else if (parsed.containerPrefix == 'B') type = BLOOM;
     else {
         throw runtime_error("Неизвестный префикс контейнера: " + string(1, parsed.containerPrefix));
     }
     
     // Обработка по типу контейнера
     string& containerName = parsed.containerName;
-    string& operation = parsed.operation;
+    string_view operation = parsed.operation;
     auto& args = parsed.args;
     
     switch (type) {
@@ -650,30 +928,30 @@ void processCommand(const string& command) {
             
             if (operation == "PUSH") {
                 if (args.empty()) throw runtime_error("MPUSH требует значение");
-                arr.push(args[0]);
+                arr.push(string(args[0]));
                 cout << "✓ Добавлено: " << args[0] << endl;
             }
             else if (operation == "GET") {
                 if (args.empty()) throw runtime_error("MGET требует индекс");
-                size_t index = std::stoul(args[0]);
+                size_t index = std::stoul(string(args[0]));
                 cout << "arr[" << index << "] = " << arr.get(index) << endl;
             }
             else if (operation == "INSERT") {
                 if (args.size() < 2) throw runtime_error("MINSERT требует индекс и значение");
-                size_t index = std::stoul(args[0]);
-                arr.insert(index, args[1]);
+                size_t index = std::stoul(string(args[0]));
+                arr.insert(index, string(args[1]));
                 cout << "✓ Вставлено на позицию " << index << endl;
             }
             else if (operation == "REMOVE") {
                 if (args.empty()) throw runtime_error("MREMOVE требует индекс");
-                size_t index = std::stoul(args[0]);
+                size_t index = std::stoul(string(args[0]));
                 arr.remove(index);
                 cout << "✓ Удалено с позиции " << index << endl;
             }
             else if (operation == "REPLACE") {
                 if (args.size() < 2) throw runtime_error("MREPLACE требует индекс и значение");
-                size_t index = std::stoul(args[0]);
-                arr.replace(index, args[1]);
+                size_t index = std::stoul(string(args[0]));
+                arr.replace(index, string(args[1]));
                 cout << "✓ Заменено на позиции " << index << endl;
             }
             else if (operation == "SIZE") {
@@ -688,7 +966,7 @@ void processCommand(const string& command) {
                 cout << "✓ Массив очищен" << endl;
             }
             else {
-                throw runtime_error("Неизвестная операция для ARRAY: " + operation);
+                throw runtime_error("Неизвестная операция для ARRAY: " + string(operation));
             }
             break;
         }
@@ -704,7 +982,7 @@ void processCommand(const string& command) {
             
             if (operation == "PUSH") {
                 if (args.empty()) throw runtime_error("SPUSH требует значение");
-                stack.push(args[0]);
+                stack.push(string(args[0]));
                 cout << "✓ Добавлено в стек: " << args[0] << endl;
             }
             else if (operation == "POP") {
@@ -726,7 +1004,7 @@ void processCommand(const string& command) {
                 cout << "✓ Стек очищен" << endl;
             }
             else {
-                throw runtime_error("Неизвестная операция для STACK: " + operation);
+                throw runtime_error("Неизвестная операция для STACK: " + string(operation));
             }
             break;
         }
@@ -742,7 +1020,7 @@ void processCommand(const string& command) {
             
             if (operation == "PUSH" || operation == "ENQUEUE") {
                 if (args.empty()) throw runtime_error("QPUSH требует значение");
-                queue.enqueue(args[0]);
+                queue.enqueue(string(args[0]));
                 cout << "✓ Добавлено в очередь: " << args[0] << endl;
             }
             else if (operation == "POP" || operation == "DEQUEUE") {
@@ -764,7 +1042,7 @@ void processCommand(const string& command) {
                 cout << "✓ Очередь очищена" << endl;
             }
             else {
-                throw runtime_error("Неизвестная операция для QUEUE: " + operation);
+                throw runtime_error("Неизвестная операция для QUEUE: " + string(operation));
             }
             break;
         }
@@ -780,12 +1058,35 @@ void processCommand(const string& command) {
             
             if (operation == "PUT") {
                 if (args.size() < 2) throw runtime_error("HPUT требует ключ и значение");
-                map.put(args[0], args[1]);
+                map.put(string(args[0]), string(args[1]));
                 cout << "✓ Добавлено: " << args[0] << " => " << args[1] << endl;
             }
             else if (operation == "GET") {
                 if (args.empty()) throw runtime_error("HGET требует ключ");
-                cout << map.get(args[0]) << endl;
+                const string* value = map.find(args[0]);
+                if (!value) throw runtime_error("Ключ не найден");
+                cout << *value << endl;
+            }
+            else if (operation == "MGET") {
+                if (args.empty()) throw runtime_error("HMGET требует хотя бы один ключ");
+                vector<const string*> values = map.getMany(args);
+                for (size_t i = 0; i < args.size(); i++) {
+                    cout << args[i] << " => ";
+                    if (values[i]) cout << *values[i] << endl;
+                    else cout << "(нет)" << endl;
+                }
+            }
+            else if (operation == "MSET") {
+                if (args.empty() || args.size() % 2 != 0) {
+                    throw runtime_error("HMSET требует пары ключ значение");
+                }
+                vector<pair<string, string>> items;
+                items.reserve(args.size() / 2);
+                for (size_t i = 0; i < args.size(); i += 2) {
+                    items.emplace_back(string(args[i]), string(args[i + 1]));
+                }
+                map.putMany(items);
+                cout << "✓ Добавлено пар: " << items.size() << endl;
             }
             else if (operation == "CONTAINS") {
                 if (args.empty()) throw runtime_error("HCONTAINS требует ключ");
@@ -793,12 +1094,42 @@ void processCommand(const string& command) {
             }
             else if (operation == "REMOVE") {
                 if (args.empty()) throw runtime_error("HREMOVE требует ключ");
-                map.remove(args[0]);
+                map.remove(string(args[0]));
                 cout << "✓ Удалено: " << args[0] << endl;
             }
             else if (operation == "SIZE") {
                 cout << "Размер: " << map.size() << endl;
             }
+            else if (operation == "RESERVE") {
+                if (args.empty()) throw runtime_error("HRESERVE требует количество элементов");
+                map.reserve(std::stoul(string(args[0])));
+                cout << "✓ Ёмкость: " << map.bucketCount() << endl;
+            }
+            else if (operation == "SHRINK") {
+                map.shrink_to_fit();
+                cout << "✓ Ёмкость: " << map.bucketCount() << endl;
+            }
+            else if (operation == "MODE") {
+                if (args.empty()) throw runtime_error("HMODE требует режим FULL или INCREMENTAL");
+                if (args[0] == "INCREMENTAL") {
+                    map.setRehashMode(HashMap<string, string>::INCREMENTAL_REHASH);
+                } else if (args[0] == "FULL") {
+                    map.setRehashMode(HashMap<string, string>::FULL_REHASH);
+                } else {
+                    throw runtime_error("Неизвестный режим рехеширования: " + string(args[0]));
+                }
+                cout << "✓ Режим рехеширования: " << args[0] << endl;
+            }
+            else if (operation == "STATS") {
+                cout << "Размер: " << map.size()
+                     << ", ёмкость: " << map.bucketCount()
+                     << ", заполненность: " << map.loadFactor()
+                     << " (макс. " << map.maxLoadFactor() << ")"
+                     << ", макс. расстояние пробы: " << map.maxProbeDistance()
+                     << ", рехеширование: "
+                     << (map.rehashMode() == HashMap<string, string>::INCREMENTAL_REHASH ? "INCREMENTAL" : "FULL")
+                     << (map.isRehashing() ? " (идёт перенос)" : "") << endl;
+            }
             else if (operation == "PRINT") {
                 map.print();
                 cout << endl;
@@ -808,7 +1139,7 @@ void processCommand(const string& command) {
                 cout << "✓ HashMap очищена" << endl;
             }
             else {
-                throw runtime_error("Неизвестная операция для HASHMAP: " + operation);
+                throw runtime_error("Неизвестная операция для HASHMAP: " + string(operation));
             }
             break;
         }
@@ -824,7 +1155,7 @@ void processCommand(const string& command) {
             
             if (operation == "INSERT" || operation == "PUSH") {
                 if (args.empty()) throw runtime_error("TINSERT требует значение");
-                tree.insert(args[0]);
+                tree.insert(string(args[0]));
                 cout << "✓ Добавлено в дерево: " << args[0] << endl;
             }
             else if (operation == "SEARCH") {
@@ -833,7 +1164,7 @@ void processCommand(const string& command) {
             }
             else if (operation == "REMOVE") {
                 if (args.empty()) throw runtime_error("TREMOVE требует значение");
-                tree.remove(args[0]);
+                tree.remove(string(args[0]));
                 cout << "✓ Удалено: " << args[0] << endl;
             }
             else if (operation == "SIZE") {
@@ -842,6 +1173,43 @@ void processCommand(const string& command) {
             else if (operation == "HEIGHT") {
                 cout << "Высота: " << tree.height() << endl;
             }
+            else if (operation == "LOADSORTED") {
+                // Файл значений через пробел (формат saveToFile); возрастающие
+                // значения строятся в дерево за O(n), прочие сортируются
+                if (args.empty()) throw runtime_error("TLOADSORTED требует имя файла");
+                tree.loadFromFile(string(args[0]));
+                cout << "✓ Загружено в дерево: " << tree.size() << " элементов, высота " << tree.height() << endl;
+            }
+            else if (operation == "RANK") {
+                if (args.empty()) throw runtime_error("TRANK требует значение");
+                cout << "Ранг: " << tree.rank(args[0]) << endl;
+            }
+            else if (operation == "SELECT") {
+                if (args.empty()) throw runtime_error("TSELECT требует номер");
+                cout << tree.select(std::stoul(string(args[0]))) << endl;
+            }
+            else if (operation == "RANGE") {
+                // TRANGE <name> <lo> <hi> [LIMIT n]: спуск к lo за O(log n),
+                // затем шаги итератора по порядку
+                if (args.size() < 2) throw runtime_error("TRANGE требует границы lo и hi");
+                size_t limit = std::numeric_limits<size_t>::max();
+                if (args.size() >= 3) {
+                    if (args[2] != "LIMIT" || args.size() < 4) {
+                        throw runtime_error("TRANGE: после границ ожидается LIMIT <n>");
+                    }
+                    limit = std::stoul(string(args[3]));
+                }
+                size_t shown = 0;
+                for (auto it = tree.lower_bound(args[0]); it != tree.end() && shown < limit && !(args[1] < *it); ++it) {
+                    cout << *it << endl;
+                    shown++;
+                }
+                cout << "(элементов: " << shown << ")" << endl;
+            }
+            else if (operation == "COUNTRANGE") {
+                if (args.size() < 2) throw runtime_error("TCOUNTRANGE требует границы lo и hi");
+                cout << "Количество: " << tree.countRange(args[0], args[1]) << endl;
+            }
             else if (operation == "PRINT") {
                 tree.print();
                 cout << endl;
@@ -851,14 +1219,193 @@ void processCommand(const string& command) {
                 cout << "✓ Дерево очищено" << endl;
             }
             else {
-                throw runtime_error("Неизвестная операция для TREE: " + operation);
+                throw runtime_error("Неизвестная операция для TREE: " + string(operation));
+            }
+            break;
+        }
+        
+        case SET: {
+            if (operation == "UNIONSTORE" || operation == "INTERSTORE" || operation == "DIFFSTORE") {
+                if (args.size() < 2) throw runtime_error("E" + string(operation) + " требует приёмник и минимум два множества");
+                // Результат строится целиком до записи: приёмник может быть среди входов.
+                // Кодировку результата задают входы
+                string_view base = operation.substr(0, operation.size() - 5);
+                size_t stored;
+                if (roaringSets.count(string(args[0]))) {
+                    RoaringSet<uint32_t> result = combineSets(roaringSets, base, args);
+                    result.optimize();
+                    stored = result.size();
+                    sets.erase(containerName);
+                    roaringSets[containerName] = std::move(result);
+                } else {
+                    Set<string> result = combineSets(sets, base, args);
+                    stored = result.size();
+                    roaringSets.erase(containerName);
+                    sets[containerName] = std::move(result);
+                }
+                cout << "✓ Сохранено в '" << containerName << "': " << stored << " элементов" << endl;
+                break;
+            }
+            auto roaring = roaringSets.find(containerName);
+            if (roaring != roaringSets.end()) {
+                processRoaringSet(roaring->second, containerName, operation, args);
+                break;
+            }
+            
+            if (sets.find(containerName) == sets.end()) {
+                sets.emplace(std::piecewise_construct,
+                            std::forward_as_tuple(containerName),
+                            std::forward_as_tuple());
+            }
+            
+            auto& set = sets.at(containerName);
+            
+            if (operation == "ADD" || operation == "PUSH") {
+                if (args.empty()) throw runtime_error("EADD требует значение");
+                set.add(string(args[0]));
+                cout << "✓ Добавлено в множество: " << args[0] << endl;
+            }
+            else if (operation == "CONTAINS") {
+                if (args.empty()) throw runtime_error("ECONTAINS требует значение");
+                cout << (set.contains(args[0]) ? "Да" : "Нет") << endl;
+            }
+            else if (operation == "REMOVE") {
+                if (args.empty()) throw runtime_error("EREMOVE требует значение");
+                set.remove(string(args[0]));
+                cout << "✓ Удалено: " << args[0] << endl;
+            }
+            else if (operation == "SIZE") {
+                cout << "Размер: " << set.size() << endl;
+            }
+            else if (operation == "STATS") {
+                cout << "Размер: " << set.size() << ", кодировка: HASH, слотов: " << set.bucketCount()
+                     << ", память: " << set.memoryUsage() << " байт" << endl;
+            }
+            else if (operation == "PRINT") {
+                set.print();
+                cout << endl;
+            }
+            else if (operation == "CLEAR") {
+                set.clear();
+                cout << "✓ Множество очищено" << endl;
+            }
+            else if (operation == "UNION" || operation == "INTER" || operation == "DIFF") {
+                if (args.empty()) throw runtime_error("E" + string(operation) + " требует минимум два множества");
+                vector<string_view> names{containerName};
+                names.insert(names.end(), args.begin(), args.end());
+                combineSets(sets, operation, names).print();
+                cout << endl;
+            }
+            else if (operation == "ADDRANGE") {
+                throw runtime_error("EADDRANGE доступна только для множеств ROARING");
+            }
+            else {
+                throw runtime_error("Неизвестная операция для SET: " + string(operation));
+            }
+            break;
+        }
+        
+        case CUCKOO: {
+            if (cuckoos.find(containerName) == cuckoos.end()) {
+                cuckoos.emplace(std::piecewise_construct,
+                               std::forward_as_tuple(containerName),
+                               std::forward_as_tuple());
+            }
+            
+            auto& map = cuckoos.at(containerName);
+            
+            if (operation == "PUT") {
+                if (args.size() < 2) throw runtime_error("CPUT требует ключ и значение");
+                map.put(string(args[0]), string(args[1]));
+                cout << "✓ Добавлено: " << args[0] << " => " << args[1] << endl;
+            }
+            else if (operation == "GET") {
+                if (args.empty()) throw runtime_error("CGET требует ключ");
+                cout << map.get(string(args[0])) << endl;
+            }
+            else if (operation == "CONTAINS") {
+                if (args.empty()) throw runtime_error("CCONTAINS требует ключ");
+                cout << (map.contains(string(args[0])) ? "Да" : "Нет") << endl;
+            }
+            else if (operation == "REMOVE") {
+                if (args.empty()) throw runtime_error("CREMOVE требует ключ");
+                if (map.remove(string(args[0]))) {
+                    cout << "✓ Удалено: " << args[0] << endl;
+                } else {
+                    cout << "⚠ Ключ не найден: " << args[0] << endl;
+                }
+            }
+            else if (operation == "SIZE") {
+                cout << "Размер: " << map.size() << endl;
+            }
+            else if (operation == "STATS") {
+                cout << "Размер: " << map.size()
+                     << ", слотов: " << map.bucketCount()
+                     << ", заполненность: " << map.loadFactor()
+                     << ", в стэше: " << map.stashSize() << endl;
+            }
+            else if (operation == "PRINT") {
+                map.print();
+                cout << endl;
+            }
+            else if (operation == "CLEAR") {
+                map.clear();
+                cout << "✓ Кукушкина хеш-таблица очищена" << endl;
+            }
+            else {
+                throw runtime_error("Неизвестная операция для CUCKOO: " + string(operation));
+            }
+            break;
+        }
+        
+        case BLOOM: {
+            if (blooms.find(containerName) == blooms.end()) {
+                blooms.emplace(std::piecewise_construct,
+                              std::forward_as_tuple(containerName),
+                              std::forward_as_tuple());
+            }
+            
+            auto& filter = blooms.at(containerName);
+            
+            if (operation == "ADD") {
+                if (args.empty()) throw runtime_error("BADD требует хотя бы один ключ");
+                for (string_view key : args) {
+                    filter.add(key);
+                }
+                cout << "✓ Добавлено ключей: " << args.size() << endl;
+            }
+            else if (operation == "TEST") {
+                if (args.empty()) throw runtime_error("BTEST требует ключ");
+                cout << (filter.mightContain(args[0]) ? "Возможно" : "Нет") << endl;
+            }
+            else if (operation == "MTEST") {
+                if (args.empty()) throw runtime_error("BMTEST требует хотя бы один ключ");
+                vector<bool> results = filter.mightContainMany(args);
+                for (size_t i = 0; i < args.size(); i++) {
+                    cout << args[i] << ": " << (results[i] ? "Возможно" : "Нет") << endl;
+                }
+            }
+            else if (operation == "SIZE") {
+                cout << "Добавлений: " << filter.size() << endl;
+            }
+            else if (operation == "STATS") {
+                cout << "Добавлений: " << filter.size()
+                     << ", бит: " << filter.bitCount()
+                     << ", хешей: " << filter.hashFunctions()
+                     << ", ожидаемая доля ложных: " << filter.falsePositiveRate() << endl;
+            }
+            else if (operation == "CLEAR") {
+                filter.clear();
+                cout << "✓ Фильтр Блума очищен" << endl;
+            }
+            else {
+                throw runtime_error("Неизвестная операция для BLOOM: " + string(operation));
             }
             break;
         }
         
         case SINGLE_LIST:
         case DOUBLE_LIST:
-        case SET:
             throw runtime_error("Тип контейнера еще не полностью реализован");
         
         default:
@@ -879,7 +1426,9 @@ void printHelp() {
     cout << "  T - Tree (AVL-дерево)" << endl;
     cout << "  E - Set (множество)" << endl;
     cout << "  F - SingleList (односвязный список)" << endl;
-    cout << "  L - DoubleList (двусвязный список)\n" << endl;
+    cout << "  L - DoubleList (двусвязный список)" << endl;
+    cout << "  C - CuckooHashMap (кукушкина хеш-таблица)" << endl;
+    cout << "  B - BloomFilter (фильтр Блума)\n" << endl;
     
     cout << "Операции для ARRAY (M):" << endl;
     cout << "  MPUSH <name> <value>           - Добавить элемент" << endl;
@@ -910,23 +1459,70 @@ void printHelp() {
     cout << "Операции для HASHMAP (H):" << endl;
     cout << "  HPUT <name> <key> <value> - Добавить пару" << endl;
     cout << "  HGET <name> <key>         - Получить значение" << endl;
+    cout << "  HMGET <name> <k1> [k2...]  - Получить значения пачкой" << endl;
+    cout << "  HMSET <name> <k1> <v1> [...] - Добавить пары пачкой" << endl;
     cout << "  HCONTAINS <name> <key>    - Проверить наличие" << endl;
     cout << "  HREMOVE <name> <key>      - Удалить пару" << endl;
     cout << "  HSIZE <name>              - Размер таблицы" << endl;
+    cout << "  HRESERVE <name> <n>       - Подготовить ёмкость под n элементов" << endl;
+    cout << "  HSHRINK <name>            - Сжать таблицу под текущий размер" << endl;
+    cout << "  HSTATS <name>             - Размер, ёмкость, заполненность, длина проб" << endl;
+    cout << "  HMODE <name> FULL|INCREMENTAL - Режим рехеширования при росте" << endl;
     cout << "  HPRINT <name>             - Вывести таблицу" << endl;
     cout << "  HCLEAR <name>             - Очистить таблицу\n" << endl;
     
+    cout << "Операции для SET (E):" << endl;
+    cout << "  EADD <name> <value>      - Добавить элемент" << endl;
+    cout << "  ECONTAINS <name> <value> - Проверить наличие" << endl;
+    cout << "  EREMOVE <name> <value>   - Удалить элемент" << endl;
+    cout << "  ESIZE <name>             - Размер множества" << endl;
+    cout << "  ESTATS <name>            - Размер, кодировка и занимаемая память" << endl;
+    cout << "  EADDRANGE <name> <a> <b> - Добавить целые от a до b (ROARING)" << endl;
+    cout << "  EPRINT <name>            - Вывести множество" << endl;
+    cout << "  ECLEAR <name>            - Очистить множество" << endl;
+    cout << "  EUNION <a> <b> [...]     - Объединение множеств" << endl;
+    cout << "  EINTER <a> <b> [...]     - Пересечение множеств" << endl;
+    cout << "  EDIFF <a> <b> [...]      - Разность a \\ b \\ ..." << endl;
+    cout << "  EUNIONSTORE|EINTERSTORE|EDIFFSTORE <dst> <a> <b> [...] - Записать результат в dst\n" << endl;
+    
+    cout << "Операции для CUCKOO (C):" << endl;
+    cout << "  CPUT <name> <key> <value> - Добавить пару" << endl;
+    cout << "  CGET <name> <key>         - Получить значение (O(1) в худшем случае)" << endl;
+    cout << "  CCONTAINS <name> <key>    - Проверить наличие" << endl;
+    cout << "  CREMOVE <name> <key>      - Удалить пару" << endl;
+    cout << "  CSIZE <name>              - Размер таблицы" << endl;
+    cout << "  CSTATS <name>             - Размер, число слотов, заполненность, стэш" << endl;
+    cout << "  CPRINT <name>             - Вывести таблицу" << endl;
+    cout << "  CCLEAR <name>             - Очистить таблицу\n" << endl;
+    
+    cout << "Операции для BLOOM (B):" << endl;
+    cout << "  BADD <name> <key> [...]   - Добавить ключи" << endl;
+    cout << "  BTEST <name> <key>        - Проверить: 'Нет' точно, 'Возможно' с ошибкой" << endl;
+    cout << "  BMTEST <name> <k1> [...]  - Проверить пачку ключей с предвыборкой" << endl;
+    cout << "  BSIZE <name>              - Число добавлений" << endl;
+    cout << "  BSTATS <name>             - Биты, хеши, ожидаемая доля ложных срабатываний" << endl;
+    cout << "  BCLEAR <name>             - Очистить фильтр\n" << endl;
+    
     cout << "Операции для TREE (T):" << endl;
     cout << "  TINSERT <name> <value> - Добавить элемент" << endl;
     cout << "  TSEARCH <name> <value> - Найти элемент" << endl;
     cout << "  TREMOVE <name> <value> - Удалить элемент" << endl;
     cout << "  TSIZE <name>           - Количество узлов" << endl;
     cout << "  THEIGHT <name>         - Высота дерева" << endl;
+    cout << "  TLOADSORTED <name> <file> - Заменить содержимое значениями из файла, O(n) для возрастающих" << endl;
+    cout << "  TRANK <name> <value>   - Число элементов меньше value" << endl;
+    cout << "  TSELECT <name> <k>     - k-й по возрастанию элемент (с 0)" << endl;
+    cout << "  TCOUNTRANGE <name> <lo> <hi> - Число элементов в [lo, hi]" << endl;
+    cout << "  TRANGE <name> <lo> <hi> [LIMIT n] - Элементы из [lo, hi] по возрастанию" << endl;
     cout << "  TPRINT <name>          - Вывести дерево" << endl;
     cout << "  TCLEAR <name>          - Очистить дерево\n" << endl;
     
     cout << "Управление контейнерами:" << endl;
     cout << "  CREATE <TYPE> <NAME>  - Создать пустой контейнер" << endl;
+    cout << "  CREATE HASHMAP <NAME> [capacity] [maxload] [INCREMENTAL] - Хеш-таблица с заданной ёмкостью" << endl;
+    cout << "  CREATE CUCKOO <NAME> [capacity] - Кукушкина хеш-таблица" << endl;
+    cout << "  CREATE SET <NAME> [HASH|ROARING] - Множество; ROARING - сжатое множество целых" << endl;
+    cout << "  CREATE BLOOM <NAME> [expected] [fpr] - Фильтр Блума под число ключей и долю ложных" << endl;
     cout << "  DELETE <TYPE> <NAME>  - Удалить контейнер" << endl;
     cout << "  LIST                  - Показать все контейнеры\n" << endl;
     
@@ -16,7 +16,9 @@ enum ContainerType {
     QUEUE,
     HASHMAP,
     SET,
-    AVLTREE
+    AVLTREE,
+    CUCKOO,
+    BLOOM
 };
 
 // Операции
@@ -45,7 +47,10 @@ extern std::map<std::string, Stack<std::string>> stacks;
 extern std::map<std::string, Queue<std::string>> queues;
 extern std::map<std::string, HashMap<std::string, std::string>> hashmaps;
 extern std::map<std::string, Set<std::string>> sets;
+extern std::map<std::string, RoaringSet<uint32_t>> roaringSets;
 extern std::map<std::string, AVLTree<std::string>> trees;
+extern std::map<std::string, CuckooHashMap<std::string, std::string>> cuckoos;
+extern std::map<std::string, BloomFilter<std::string>> blooms;
 
 // Основные функции
 void processCommand(const std::string& command);
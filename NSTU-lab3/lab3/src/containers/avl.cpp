@@ -1,70 +1,102 @@
 #ifndef AVL_CPP
 #define AVL_CPP
 
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
+#include <type_traits>
 #include "../binary_serialization.h"
 #include "trees.h"
 
-template<typename T>
-AVLTree<T>::Node::Node(const T& value) 
-    : data(value), height(1), left(nullptr), right(nullptr) {}
+template<typename T, typename Aggregate>
+AVLTree<T, Aggregate>::Node::Node(const T& value) 
+    : data(value), height(1), size(1), left(nullptr), right(nullptr), parent(nullptr) {
+    if constexpr (HAS_AGGREGATE) {
+        this->aggregate = Aggregate::of(data);
+    }
+}
+
+template<typename T, typename Aggregate>
+AVLTree<T, Aggregate>::Node::Node(T&& value) 
+    : data(std::move(value)), height(1), size(1), left(nullptr), right(nullptr), parent(nullptr) {
+    if constexpr (HAS_AGGREGATE) {
+        this->aggregate = Aggregate::of(data);
+    }
+}
 
-template<typename T>
-AVLTree<T>::AVLTree() : root(nullptr), count(0) {}
+template<typename T, typename Aggregate>
+AVLTree<T, Aggregate>::AVLTree() : root(nullptr), count(0) {}
 
-template<typename T>
-AVLTree<T>::~AVLTree() {
+template<typename T, typename Aggregate>
+AVLTree<T, Aggregate>::~AVLTree() {
     clear();
 }
 
-template<typename T>
-int AVLTree<T>::getHeight(Node* node) const {
+template<typename T, typename Aggregate>
+int AVLTree<T, Aggregate>::getHeight(Node* node) const {
     return node ? node->height : 0;
 }
 
-template<typename T>
-int AVLTree<T>::getBalance(Node* node) const {
+template<typename T, typename Aggregate>
+int AVLTree<T, Aggregate>::getBalance(Node* node) const {
     return node ? getHeight(node->left) - getHeight(node->right) : 0;
 }
 
-template<typename T>
-void AVLTree<T>::updateHeight(Node* node) {
+template<typename T, typename Aggregate>
+size_t AVLTree<T, Aggregate>::getSize(Node* node) const {
+    return node ? node->size : 0;
+}
+
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::updateNode(Node* node) {
     if (node) {
         node->height = 1 + std::max(getHeight(node->left), getHeight(node->right));
+        node->size = 1 + getSize(node->left) + getSize(node->right);
+        if constexpr (HAS_AGGREGATE) {
+            typename Aggregate::value_type value = Aggregate::of(node->data);
+            if (node->left) value = Aggregate::combine(node->left->aggregate, value);
+            if (node->right) value = Aggregate::combine(value, node->right->aggregate);
+            node->aggregate = value;
+        }
     }
 }
 
-template<typename T>
-typename AVLTree<T>::Node* AVLTree<T>::rotateRight(Node* y) {
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::Node* AVLTree<T, Aggregate>::rotateRight(Node* y) {
     Node* x = y->left;
     Node* B = x->right;
     
     x->right = y;
     y->left = B;
+    x->parent = y->parent;
+    y->parent = x;
+    if (B) B->parent = y;
     
-    updateHeight(y);
-    updateHeight(x);
+    updateNode(y);
+    updateNode(x);
     
     return x;
 }
 
-template<typename T>
-typename AVLTree<T>::Node* AVLTree<T>::rotateLeft(Node* x) {
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::Node* AVLTree<T, Aggregate>::rotateLeft(Node* x) {
     Node* y = x->right;
     Node* B = y->left;
     
     y->left = x;
     x->right = B;
+    y->parent = x->parent;
+    x->parent = y;
+    if (B) B->parent = x;
     
-    updateHeight(x);
-    updateHeight(y);
+    updateNode(x);
+    updateNode(y);
     
     return y;
 }
 
-template<typename T>
-typename AVLTree<T>::Node* AVLTree<T>::rebalance(Node* node) {
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::Node* AVLTree<T, Aggregate>::rebalance(Node* node) {
     if (!node) return nullptr;
     
     int balance = getBalance(node);
@@ -86,138 +118,418 @@ typename AVLTree<T>::Node* AVLTree<T>::rebalance(Node* node) {
     return node;
 }
 
-template<typename T>
-typename AVLTree<T>::Node* AVLTree<T>::insertNode(Node* node, const T& value) {
-    if (!node) {
-        count++;
-        return new Node(value);
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::retrace(Node** links[], int depth, bool grew) {
+    // Размеры меняются у всех предков, поэтому подъём идёт до корня.
+    // Когда высота поддерева перестала меняться, выше балансы прежние:
+    // размер правится на единицу без чтения соседних узлов
+    bool settled = false;
+    while (depth > 0) {
+        Node** link = links[--depth];
+        Node* node = *link;
+        if (settled) {
+            if constexpr (HAS_AGGREGATE) {
+                updateNode(node);
+            } else {
+                node->size = grew ? node->size + 1 : node->size - 1;
+            }
+            continue;
+        }
+        int before = node->height;
+        updateNode(node);
+        *link = rebalance(node);
+        settled = (*link)->height == before;
+    }
+}
+
+template<typename T, typename Aggregate>
+bool AVLTree<T, Aggregate>::insertNode(const T& value) {
+    Node** links[MAX_HEIGHT];
+    int depth = 0;
+    Node** link = &root;
+    Node* parent = nullptr;
+    while (*link) {
+        parent = *link;
+        links[depth++] = link;
+        if (value < parent->data) {
+            link = &parent->left;
+        } else if (value > parent->data) {
+            link = &parent->right;
+        } else {
+            return false;
+        }
+    }
+    
+    *link = pool.create(value);
+    (*link)->parent = parent;
+    count++;
+    retrace(links, depth, true);
+    return true;
+}
+
+template<typename T, typename Aggregate>
+bool AVLTree<T, Aggregate>::deleteNode(const T& value) {
+    Node** links[MAX_HEIGHT];
+    int depth = 0;
+    Node** link = &root;
+    while (*link && !(value == (*link)->data)) {
+        links[depth++] = link;
+        link = value < (*link)->data ? &(*link)->left : &(*link)->right;
     }
+    Node* node = *link;
+    if (!node) return false;
     
-    if (value < node->data) {
-        node->left = insertNode(node->left, value);
-    } else if (value > node->data) {
-        node->right = insertNode(node->right, value);
-    } else {
-        return node;
+    if (node->left && node->right) {
+        // Данные заменяются минимумом правого поддерева, удаляется его узел
+        links[depth++] = link;
+        link = &node->right;
+        while ((*link)->left) {
+            links[depth++] = link;
+            link = &(*link)->left;
+        }
+        Node* successor = *link;
+        node->data = std::move(successor->data);
+        node = successor;
     }
     
-    updateHeight(node);
-    return rebalance(node);
+    Node* child = node->left ? node->left : node->right;
+    if (child) child->parent = node->parent;
+    *link = child;
+    pool.destroy(node);
+    count--;
+    retrace(links, depth, false);
+    return true;
+}
+
+template<typename T, typename Aggregate>
+template<typename Q>
+bool AVLTree<T, Aggregate>::searchNode(const Q& value) const {
+    Node* node = root;
+    while (node) {
+        if (value == node->data) return true;
+        node = value < node->data ? node->left : node->right;
+    }
+    return false;
+}
+
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::clearNode(Node* node) {
+    // Левый ребёнок поворотом поднимается наверх, узел без левого
+    // ребёнка уничтожается: O(n) без стека и рекурсии
+    while (node) {
+        if (node->left) {
+            Node* left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+        } else {
+            Node* right = node->right;
+            pool.destroy(node);
+            node = right;
+        }
+    }
 }
 
-template<typename T>
-typename AVLTree<T>::Node* AVLTree<T>::findMin(Node* node) const {
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::inorderTraversal(Node* node, std::ostream& os) const {
+    Node* stack[MAX_HEIGHT];
+    int top = 0;
+    while (node || top > 0) {
+        while (node) {
+            stack[top++] = node;
+            node = node->left;
+        }
+        node = stack[--top];
+        os << node->data << " ";
+        node = node->right;
+    }
+}
+
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::Node* AVLTree<T, Aggregate>::leftmost(Node* node) {
     while (node && node->left) {
         node = node->left;
     }
     return node;
 }
 
-template<typename T>
-typename AVLTree<T>::Node* AVLTree<T>::deleteNode(Node* node, const T& value) {
-    if (!node) return nullptr;
-    
-    if (value < node->data) {
-        node->left = deleteNode(node->left, value);
-    } else if (value > node->data) {
-        node->right = deleteNode(node->right, value);
-    } else {
-        if (!node->left || !node->right) {
-            Node* temp = node->left ? node->left : node->right;
-            if (!temp) {
-                temp = node;
-                node = nullptr;
-            } else {
-                *node = *temp;
-            }
-            delete temp;
-            count--;
-        } else {
-            Node* temp = findMin(node->right);
-            node->data = temp->data;
-            node->right = deleteNode(node->right, temp->data);
-        }
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::Node* AVLTree<T, Aggregate>::rightmost(Node* node) {
+    while (node && node->right) {
+        node = node->right;
     }
-    
-    if (!node) return nullptr;
-    
-    updateHeight(node);
-    return rebalance(node);
+    return node;
 }
 
-template<typename T>
-bool AVLTree<T>::searchNode(Node* node, const T& value) const {
-    if (!node) return false;
-    if (value == node->data) return true;
-    if (value < node->data) {
-        return searchNode(node->left, value);
-    } else {
-        return searchNode(node->right, value);
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::Node* AVLTree<T, Aggregate>::successor(Node* node) {
+    if (node->right) {
+        return leftmost(node->right);
     }
+    // Вверх, пока приходим из правого поддерева
+    while (node->parent && node->parent->right == node) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::Node* AVLTree<T, Aggregate>::predecessor(Node* node) {
+    if (node->left) {
+        return rightmost(node->left);
+    }
+    while (node->parent && node->parent->left == node) {
+        node = node->parent;
+    }
+    return node->parent;
 }
 
-template<typename T>
-void AVLTree<T>::clearNode(Node* node) {
-    if (!node) return;
-    clearNode(node->left);
-    clearNode(node->right);
-    delete node;
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::insert(const T& value) {
+    insertNode(value);
+}
+
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::buildBalanced(std::vector<T>& values) {
+    // Середина отрезка - корень, половины - поддеревья. Узлы создаются в
+    // прямом порядке, отрезки ждут в стеке: не больше одного на уровень
+    struct Range {
+        size_t lo, hi;
+        Node** link;
+        Node* parent;
+    };
+    Range stack[MAX_HEIGHT + 1];
+    int top = 0;
+    stack[top++] = {0, values.size(), &root, nullptr};
+    while (top > 0) {
+        Range range = stack[--top];
+        size_t length = range.hi - range.lo;
+        if (length == 0) continue;
+        
+        size_t mid = range.lo + length / 2;
+        Node* node = pool.create(std::move(values[mid]));
+        node->parent = range.parent;
+        node->size = length;
+        // Левая половина не меньше правой: высота - число бит в length
+        node->height = 0;
+        for (size_t rest = length; rest > 0; rest >>= 1) {
+            node->height++;
+        }
+        *range.link = node;
+        stack[top++] = {mid + 1, range.hi, &node->right, node};
+        stack[top++] = {range.lo, mid, &node->left, node};
+    }
+    count = values.size();
+    
+    // Агрегат узла зависит от детей - отдельный обратный проход
+    if constexpr (HAS_AGGREGATE) {
+        restoreHeights();
+    }
 }
 
-template<typename T>
-void AVLTree<T>::inorderTraversal(Node* node, std::ostream& os) const {
-    if (!node) return;
-    inorderTraversal(node->left, os);
-    os << node->data << " ";
-    inorderTraversal(node->right, os);
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::bulkLoad(std::vector<T> values) {
+    clear();
+    if (!std::is_sorted(values.begin(), values.end())) {
+        std::sort(values.begin(), values.end());
+    }
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    try {
+        buildBalanced(values);
+    } catch (...) {
+        clear();
+        throw;
+    }
 }
 
-template<typename T>
-void AVLTree<T>::insert(const T& value) {
-    root = insertNode(root, value);
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::remove(const T& value) {
+    deleteNode(value);
 }
 
-template<typename T>
-void AVLTree<T>::remove(const T& value) {
-    root = deleteNode(root, value);
+template<typename T, typename Aggregate>
+bool AVLTree<T, Aggregate>::search(const T& value) const {
+    return searchNode(value);
 }
 
-template<typename T>
-bool AVLTree<T>::search(const T& value) const {
-    return searchNode(root, value);
+template<typename T, typename Aggregate>
+template<typename Q>
+bool AVLTree<T, Aggregate>::search(const Q& value) const {
+    return searchNode(value);
 }
 
-template<typename T>
-void AVLTree<T>::clear() {
-    clearNode(root);
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::clear() {
+    // Узлы живут в слэбах пула: обход нужен, только если у узла есть
+    // деструктор - у данных или у поля агрегата
+    if constexpr (!std::is_trivially_destructible<Node>::value) {
+        clearNode(root);
+    }
+    pool.release();
     root = nullptr;
     count = 0;
 }
 
-template<typename T>
-size_t AVLTree<T>::size() const {
+template<typename T, typename Aggregate>
+size_t AVLTree<T, Aggregate>::size() const {
     return count;
 }
 
-template<typename T>
-bool AVLTree<T>::empty() const {
+template<typename T, typename Aggregate>
+bool AVLTree<T, Aggregate>::empty() const {
     return root == nullptr;
 }
 
-template<typename T>
-int AVLTree<T>::height() const {
+template<typename T, typename Aggregate>
+int AVLTree<T, Aggregate>::height() const {
     return getHeight(root);
 }
 
-template<typename T>
-void AVLTree<T>::print(std::ostream& os) const {
+template<typename T, typename Aggregate>
+template<typename Q>
+size_t AVLTree<T, Aggregate>::rank(const Q& value) const {
+    size_t less = 0;
+    Node* node = root;
+    while (node) {
+        if (node->data < value) {
+            less += getSize(node->left) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return less;
+}
+
+template<typename T, typename Aggregate>
+const T& AVLTree<T, Aggregate>::select(size_t k) const {
+    if (k >= count) {
+        throw std::out_of_range("Номер за пределами дерева");
+    }
+    Node* node = root;
+    while (true) {
+        size_t leftSize = getSize(node->left);
+        if (k < leftSize) {
+            node = node->left;
+        } else if (k == leftSize) {
+            return node->data;
+        } else {
+            k -= leftSize + 1;
+            node = node->right;
+        }
+    }
+}
+
+template<typename T, typename Aggregate>
+template<typename Q>
+size_t AVLTree<T, Aggregate>::countRange(const Q& lo, const Q& hi) const {
+    if (hi < lo) return 0;
+    // Элементы не больше hi минус элементы меньше lo
+    size_t notGreater = 0;
+    Node* node = root;
+    while (node) {
+        if (hi < node->data) {
+            node = node->left;
+        } else {
+            notGreater += getSize(node->left) + 1;
+            node = node->right;
+        }
+    }
+    return notGreater - rank(lo);
+}
+
+template<typename T, typename Aggregate>
+template<typename Q>
+typename Aggregate::value_type AVLTree<T, Aggregate>::aggregateRange(const Q& lo, const Q& hi) const {
+    static_assert(HAS_AGGREGATE, "aggregateRange требует политику агрегата");
+    using Value = typename Aggregate::value_type;
+    auto subtree = [](Node* node) { return node ? node->aggregate : Aggregate::identity(); };
+
+    // Узел расщепления: первый, попавший в [lo, hi]
+    Node* split = root;
+    while (split && (split->data < lo || hi < split->data)) {
+        split = split->data < lo ? split->right : split->left;
+    }
+    if (!split) return Aggregate::identity();
+
+    // Левая граница: узел в отрезке забирает себя и правое поддерево,
+    // собранное лежит правее всего, что встретится дальше
+    Value left = Aggregate::identity();
+    for (Node* node = split->left; node; ) {
+        if (node->data < lo) {
+            node = node->right;
+        } else {
+            left = Aggregate::combine(Aggregate::combine(Aggregate::of(node->data), subtree(node->right)), left);
+            node = node->left;
+        }
+    }
+    // Правая граница - зеркально
+    Value right = Aggregate::identity();
+    for (Node* node = split->right; node; ) {
+        if (hi < node->data) {
+            node = node->left;
+        } else {
+            right = Aggregate::combine(right, Aggregate::combine(subtree(node->left), Aggregate::of(node->data)));
+            node = node->right;
+        }
+    }
+    return Aggregate::combine(Aggregate::combine(left, Aggregate::of(split->data)), right);
+}
+
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::const_iterator AVLTree<T, Aggregate>::begin() const {
+    return const_iterator(this, leftmost(root));
+}
+
+template<typename T, typename Aggregate>
+typename AVLTree<T, Aggregate>::const_iterator AVLTree<T, Aggregate>::end() const {
+    return const_iterator(this, nullptr);
+}
+
+template<typename T, typename Aggregate>
+template<typename Q>
+typename AVLTree<T, Aggregate>::const_iterator AVLTree<T, Aggregate>::lower_bound(const Q& value) const {
+    Node* found = nullptr;
+    for (Node* node = root; node; ) {
+        if (node->data < value) {
+            node = node->right;
+        } else {
+            found = node;
+            node = node->left;
+        }
+    }
+    return const_iterator(this, found);
+}
+
+template<typename T, typename Aggregate>
+template<typename Q>
+typename AVLTree<T, Aggregate>::const_iterator AVLTree<T, Aggregate>::upper_bound(const Q& value) const {
+    Node* found = nullptr;
+    for (Node* node = root; node; ) {
+        if (value < node->data) {
+            found = node;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    return const_iterator(this, found);
+}
+
+template<typename T, typename Aggregate>
+size_t AVLTree<T, Aggregate>::memoryUsage() const {
+    return pool.memoryUsage();
+}
+
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::print(std::ostream& os) const {
     os << "AVLTree [";
     inorderTraversal(root, os);
     os << "] (size: " << count << ", height: " << height() << ")";
 }
 
-template<typename T>
-void AVLTree<T>::saveToFile(const std::string& filename) const {
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::saveToFile(const std::string& filename) const {
     std::ofstream file(filename);
     if (!file) {
         throw std::runtime_error("Не удалось открыть файл для записи");
@@ -226,140 +538,126 @@ void AVLTree<T>::saveToFile(const std::string& filename) const {
     file.close();
 }
 
-template<typename T>
-void AVLTree<T>::loadFromFile(const std::string& filename) {
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::loadFromFile(const std::string& filename) {
     std::ifstream file(filename);
     if (!file) {
         throw std::runtime_error("Не удалось открыть файл для чтения");
     }
-    clear();
+    // saveToFile пишет по возрастанию - такой файл строится за O(n)
+    std::vector<T> values;
     T value;
     while (file >> value) {
-        insert(value);
+        values.push_back(value);
     }
     file.close();
+    bulkLoad(std::move(values));
 }
 
-// Бинарная сериализация для AVLTree<string>
-template<>
-inline void AVLTree<std::string>::saveBinaryNode(std::ofstream& out, Node* node) const {
-    if (node == nullptr) {
-        uint8_t null_marker = 0;
-        out.write(reinterpret_cast<const char*>(&null_marker), sizeof(null_marker));
-        return;
+// Бинарная сериализация: количество, затем узлы в прямом порядке с
+// маркером 1 перед узлом и 0 на месте пустого поддерева
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::saveBinaryNode(std::ofstream& out, Node* node) const {
+    // Правые поддеревья ждут в стеке: не больше одного на уровень
+    Node* stack[MAX_HEIGHT + 1];
+    int top = 0;
+    stack[top++] = node;
+    while (top > 0) {
+        node = stack[--top];
+        uint8_t marker = node ? 1 : 0;
+        out.write(reinterpret_cast<const char*>(&marker), sizeof(marker));
+        if (!node) continue;
+        writeValue(out, node->data);
+        stack[top++] = node->right;
+        stack[top++] = node->left;
     }
-    
-    uint8_t node_marker = 1;
-    out.write(reinterpret_cast<const char*>(&node_marker), sizeof(node_marker));
-    
-    // Записываем данные узла
-    uint32_t strLen = static_cast<uint32_t>(node->data.length());
-    out.write(reinterpret_cast<const char*>(&strLen), sizeof(strLen));
-    out.write(node->data.c_str(), strLen);
-    
-    // Рекурсивно записываем детей
-    saveBinaryNode(out, node->left);
-    saveBinaryNode(out, node->right);
 }
 
-template<>
-inline AVLTree<std::string>::Node* AVLTree<std::string>::loadBinaryNode(std::ifstream& in) {
-    uint8_t marker;
-    in.read(reinterpret_cast<char*>(&marker), sizeof(marker));
-    
-    if (marker == 0) {
-        return nullptr;
-    }
-    
-    // Читаем данные узла
-    uint32_t strLen;
-    in.read(reinterpret_cast<char*>(&strLen), sizeof(strLen));
-    std::string data(strLen, '\0');
-    in.read(&data[0], strLen);
-    
-    Node* node = new Node(data);
-    node->left = loadBinaryNode(in);
-    node->right = loadBinaryNode(in);
-    
-    updateHeight(node);
-    
-    return node;
-}
-
-template<>
-inline void AVLTree<std::string>::saveToBinary(std::ofstream& out) const {
-    // Записываем количество элементов
-    uint32_t sz = static_cast<uint32_t>(count);
-    out.write(reinterpret_cast<const char*>(&sz), sizeof(sz));
-    
-    // Записываем дерево
-    saveBinaryNode(out, root);
-}
-
-template<>
-inline void AVLTree<std::string>::loadFromBinary(std::ifstream& in) {
-    clear();
-    
-    // Читаем количество элементов
-    uint32_t sz;
-    in.read(reinterpret_cast<char*>(&sz), sizeof(sz));
-    
-    count = sz;
-    root = loadBinaryNode(in);
-}
-
-// Общий шаблон для других типов
-template<typename T>
-void AVLTree<T>::saveBinaryNode(std::ofstream& out, Node* node) const {
-    if (node == nullptr) {
-        uint8_t null_marker = 0;
-        out.write(reinterpret_cast<const char*>(&null_marker), sizeof(null_marker));
-        return;
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::loadBinaryNode(std::ifstream& in, size_t& loaded) {
+    // Стек незаполненных ссылок на детей. Узлы сразу подвешиваются к
+    // root, так что при ошибке дерево целиком освободит clear()
+    Node** stack[MAX_HEIGHT + 1];
+    int top = 0;
+    stack[top++] = &root;
+    while (top > 0) {
+        Node** link = stack[--top];
+        uint8_t marker;
+        if (!in.read(reinterpret_cast<char*>(&marker), sizeof(marker)) || marker > 1) {
+            throw std::runtime_error("Повреждённый снимок дерева");
+        }
+        if (marker == 0) continue;
+        
+        T data;
+        readValue(in, data);
+        if (!in || top + 2 > MAX_HEIGHT + 1) {
+            throw std::runtime_error("Повреждённый снимок дерева");
+        }
+        *link = pool.create(std::move(data));
+        loaded++;
+        stack[top++] = &(*link)->right;
+        stack[top++] = &(*link)->left;
     }
-    
-    uint8_t node_marker = 1;
-    out.write(reinterpret_cast<const char*>(&node_marker), sizeof(node_marker));
-    out.write(reinterpret_cast<const char*>(&node->data), sizeof(T));
-    
-    saveBinaryNode(out, node->left);
-    saveBinaryNode(out, node->right);
 }
 
-template<typename T>
-typename AVLTree<T>::Node* AVLTree<T>::loadBinaryNode(std::ifstream& in) {
-    uint8_t marker;
-    in.read(reinterpret_cast<char*>(&marker), sizeof(marker));
-    
-    if (marker == 0) {
-        return nullptr;
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::restoreHeights() {
+    // Обратный обход: высота узла - после высот детей, родитель - при
+    // спуске. Путь длиннее MAX_HEIGHT или разбаланс больше 1 - признак
+    // испорченного файла
+    Node* stack[MAX_HEIGHT];
+    int top = 0;
+    Node* node = root;
+    Node* last = nullptr;
+    while (node || top > 0) {
+        if (node) {
+            if (top == MAX_HEIGHT) {
+                throw std::runtime_error("Повреждённый снимок дерева");
+            }
+            node->parent = top > 0 ? stack[top - 1] : nullptr;
+            stack[top++] = node;
+            node = node->left;
+            continue;
+        }
+        Node* peek = stack[top - 1];
+        if (peek->right && last != peek->right) {
+            node = peek->right;
+        } else {
+            updateNode(peek);
+            int balance = getBalance(peek);
+            if (balance > 1 || balance < -1) {
+                throw std::runtime_error("Повреждённый снимок дерева");
+            }
+            last = peek;
+            top--;
+        }
     }
-    
-    T data;
-    in.read(reinterpret_cast<char*>(&data), sizeof(T));
-    
-    Node* node = new Node(data);
-    node->left = loadBinaryNode(in);
-    node->right = loadBinaryNode(in);
-    
-    updateHeight(node);
-    
-    return node;
 }
 
-template<typename T>
-void AVLTree<T>::saveToBinary(std::ofstream& out) const {
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::saveToBinary(std::ofstream& out) const {
     uint32_t sz = static_cast<uint32_t>(count);
     out.write(reinterpret_cast<const char*>(&sz), sizeof(sz));
     saveBinaryNode(out, root);
 }
 
-template<typename T>
-void AVLTree<T>::loadFromBinary(std::ifstream& in) {
+template<typename T, typename Aggregate>
+void AVLTree<T, Aggregate>::loadFromBinary(std::ifstream& in) {
     clear();
-    uint32_t sz;
+    uint32_t sz = 0;
     in.read(reinterpret_cast<char*>(&sz), sizeof(sz));
-    count = sz;
-    root = loadBinaryNode(in);
+    size_t loaded = 0;
+    try {
+        loadBinaryNode(in, loaded);
+        restoreHeights();
+        if (loaded != sz) {
+            throw std::runtime_error("Повреждённый снимок дерева");
+        }
+    } catch (...) {
+        clear();
+        throw;
+    }
+    count = loaded;
 }
 
 #endif
@@ -0,0 +1,223 @@
+#ifndef BLOOM_CPP
+#define BLOOM_CPP
+
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include "hash.h"
+
+// Реализация BloomFilter
+
+template<typename T, typename Hash>
+BloomFilter<T, Hash>::BloomFilter(size_t expectedItems, double targetRate)
+    : hashCount(1), count(0) {
+    if (!(targetRate > 0.0 && targetRate < 1.0)) {
+        throw std::runtime_error("Доля ложных срабатываний должна быть в интервале (0, 1)");
+    }
+    double items = static_cast<double>(std::max<size_t>(expectedItems, 1));
+
+    // Старт - размер обычного фильтра; блочному нужно чуть больше бит
+    double bitsPerKey = -std::log(targetRate) / (std::log(2.0) * std::log(2.0));
+    size_t blockCount = static_cast<size_t>(std::ceil(items * bitsPerKey / BLOCK_BITS));
+    blockCount = std::max<size_t>(blockCount, 1);
+    while (true) {
+        bitsPerKey = static_cast<double>(blockCount * BLOCK_BITS) / items;
+        hashCount = optimalHashes(bitsPerKey);
+        if (blockedFalsePositiveRate(items / static_cast<double>(blockCount), hashCount) <= targetRate) {
+            break;
+        }
+        blockCount += blockCount / 32 + 1;
+    }
+    blocks.assign(blockCount, Block{});
+}
+
+template<typename T, typename Hash>
+uint32_t BloomFilter<T, Hash>::optimalHashes(double bitsPerKey) {
+    double k = std::round(bitsPerKey * std::log(2.0));
+    return static_cast<uint32_t>(std::min<double>(std::max<double>(k, 1.0), MAX_HASHES));
+}
+
+template<typename T, typename Hash>
+double BloomFilter<T, Hash>::blockedFalsePositiveRate(double keysPerBlock, uint32_t hashes) {
+    // Сумма по числу ключей i в блоке: P(i) * (1 - (1 - 1/B)^(k*i))^k,
+    // P(i) считается в логарифмах, чтобы не уйти в ноль при большом среднем
+    double spread = 10.0 * std::sqrt(keysPerBlock) + 10.0;
+    size_t first = static_cast<size_t>(std::max(0.0, keysPerBlock - spread));
+    size_t last = static_cast<size_t>(keysPerBlock + spread);
+    double bitStaysClear = std::log1p(-1.0 / BLOCK_BITS);
+    double total = 0.0;
+    for (size_t i = first; i <= last; i++) {
+        double n = static_cast<double>(i);
+        double logPoisson = n * std::log(std::max(keysPerBlock, 1e-300)) - keysPerBlock - std::lgamma(n + 1.0);
+        double bitSet = -std::expm1(bitStaysClear * hashes * n);
+        total += std::exp(logPoisson) * std::pow(bitSet, hashes);
+    }
+    return total;
+}
+
+template<typename T, typename Hash>
+template<typename Q>
+uint64_t BloomFilter<T, Hash>::hashOf(const Q& key) const {
+    return mixHash64(static_cast<uint64_t>(hasher(key)));
+}
+
+template<typename T, typename Hash>
+size_t BloomFilter<T, Hash>::blockOf(uint64_t hash) const {
+    // Блок - по старшим битам хеша (fastrange)
+    return FastRangeReduction::reduce(static_cast<size_t>(hash), blocks.size());
+}
+
+template<typename T, typename Hash>
+template<typename F>
+void BloomFilter<T, Hash>::forEachBit(uint64_t hash, F f) const {
+    // Позиция - очередные 9 бит перемешанного хеша, 7 позиций на слово.
+    // Двойное хеширование по модулю 512 дало бы лишь 2^17 разных наборов
+    // позиций, и ключи одного блока совпадали бы в них целиком
+    uint64_t bits = mixHash64(hash ^ 0x9E3779B97F4A7C15ULL);
+    for (uint32_t i = 0; i < hashCount; i++) {
+        if (i > 0 && i % 7 == 0) {
+            bits = mixHash64(bits);
+        }
+        uint32_t bit = static_cast<uint32_t>(bits >> (i % 7 * 9)) & (BLOCK_BITS - 1);
+        f(bit >> 6, uint64_t(1) << (bit & 63));
+    }
+}
+
+template<typename T, typename Hash>
+bool BloomFilter<T, Hash>::testHashed(uint64_t hash) const {
+    const Block& block = blocks[blockOf(hash)];
+    bool present = true;
+    forEachBit(hash, [&block, &present](size_t word, uint64_t mask) {
+        present = present && (block.words[word] & mask);
+    });
+    return present;
+}
+
+template<typename T, typename Hash>
+void BloomFilter<T, Hash>::addHashed(uint64_t hash) {
+    Block& block = blocks[blockOf(hash)];
+    forEachBit(hash, [&block](size_t word, uint64_t mask) {
+        block.words[word] |= mask;
+    });
+    count++;
+}
+
+template<typename T, typename Hash>
+void BloomFilter<T, Hash>::add(const T& key) {
+    addHashed(hashOf(key));
+}
+
+template<typename T, typename Hash>
+template<typename Q, typename>
+void BloomFilter<T, Hash>::add(const Q& key) {
+    addHashed(hashOf(key));
+}
+
+template<typename T, typename Hash>
+bool BloomFilter<T, Hash>::mightContain(const T& key) const {
+    return testHashed(hashOf(key));
+}
+
+template<typename T, typename Hash>
+template<typename Q, typename>
+bool BloomFilter<T, Hash>::mightContain(const Q& key) const {
+    return testHashed(hashOf(key));
+}
+
+template<typename T, typename Hash>
+template<typename Q>
+std::vector<bool> BloomFilter<T, Hash>::mightContainMany(const std::vector<Q>& keys) const {
+    static_assert(std::is_same<Q, T>::value || IsTransparentLookup<Hash, std::equal_to<>, Q>::value,
+                  "Тип ключа не подходит к хешу фильтра");
+    std::vector<bool> results(keys.size());
+    uint64_t hashes[PREFETCH_BATCH];
+
+    for (size_t start = 0; start < keys.size(); start += PREFETCH_BATCH) {
+        size_t end = std::min(start + PREFETCH_BATCH, keys.size());
+        for (size_t i = start; i < end; i++) {
+            hashes[i - start] = hashOf(keys[i]);
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(&blocks[blockOf(hashes[i - start])]);
+#endif
+        }
+        for (size_t i = start; i < end; i++) {
+            results[i] = testHashed(hashes[i - start]);
+        }
+    }
+    return results;
+}
+
+template<typename T, typename Hash>
+void BloomFilter<T, Hash>::clear() {
+    std::fill(blocks.begin(), blocks.end(), Block{});
+    count = 0;
+}
+
+template<typename T, typename Hash>
+size_t BloomFilter<T, Hash>::size() const {
+    return count;
+}
+
+template<typename T, typename Hash>
+bool BloomFilter<T, Hash>::empty() const {
+    return count == 0;
+}
+
+template<typename T, typename Hash>
+size_t BloomFilter<T, Hash>::bitCount() const {
+    return blocks.size() * BLOCK_BITS;
+}
+
+template<typename T, typename Hash>
+uint32_t BloomFilter<T, Hash>::hashFunctions() const {
+    return hashCount;
+}
+
+template<typename T, typename Hash>
+double BloomFilter<T, Hash>::falsePositiveRate() const {
+    return blockedFalsePositiveRate(static_cast<double>(count) / static_cast<double>(blocks.size()), hashCount);
+}
+
+template<typename T, typename Hash>
+size_t BloomFilter<T, Hash>::memoryUsage() const {
+    return blocks.capacity() * sizeof(Block);
+}
+
+// Бинарная сериализация: число добавлений, число хешей, число блоков,
+// затем сами блоки
+template<typename T, typename Hash>
+void BloomFilter<T, Hash>::saveToBinary(std::ofstream& out) const {
+    writeBinary(out, count);
+    writeBinary(out, hashCount);
+    writeBinary(out, blocks.size());
+    out.write(reinterpret_cast<const char*>(blocks.data()),
+              static_cast<std::streamsize>(blocks.size() * sizeof(Block)));
+}
+
+template<typename T, typename Hash>
+void BloomFilter<T, Hash>::loadFromBinary(std::ifstream& in) {
+    size_t loadedCount = readSize(in);
+    uint32_t loadedHashes = readUint32(in);
+    size_t blockCount = readSize(in);
+    if (!in || loadedHashes == 0 || loadedHashes > MAX_HASHES ||
+        blockCount == 0 || blockCount > SIZE_MAX / sizeof(Block)) {
+        throw std::runtime_error("Повреждённый снимок фильтра Блума");
+    }
+    // Число блоков взято из файла: память растёт порциями по мере чтения,
+    // и обрезанный или испорченный снимок не выделит её заранее
+    std::vector<Block> loaded;
+    while (loaded.size() < blockCount) {
+        size_t offset = loaded.size();
+        size_t chunk = std::min(blockCount - offset, LOAD_CHUNK);
+        loaded.resize(offset + chunk);
+        in.read(reinterpret_cast<char*>(loaded.data() + offset), static_cast<std::streamsize>(chunk * sizeof(Block)));
+        if (!in) {
+            throw std::runtime_error("Повреждённый снимок фильтра Блума");
+        }
+    }
+    blocks.swap(loaded);
+    hashCount = loadedHashes;
+    count = loadedCount;
+}
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef BUCKET_CUCKOO_CPP
+#define BUCKET_CUCKOO_CPP
+
+#include <algorithm>
+#include <limits>
+#include "hash.h"
+
+// Реализация BucketCuckooHashMap
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::Bucket::Bucket() {
+    std::fill(tags, tags + SlotsPerBucket, EMPTY_TAG);
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::BucketCuckooHashMap(size_t initialCapacity)
+    : mask(0), count(0) {
+    size_t total = 2;
+    while (total * SlotsPerBucket < initialCapacity) {
+        total *= 2;
+    }
+    buckets.resize(total);
+    mask = total - 1;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+size_t BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::hashOf(const K& key) const {
+    // Индекс берётся из младших бит, отпечаток - из старших: оба должны
+    // зависеть от всего ключа, даже если Hash - тождество
+    return static_cast<size_t>(mixHash64(static_cast<uint64_t>(hasher(key))));
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+uint8_t BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::tagOf(size_t hash) {
+    uint8_t tag = static_cast<uint8_t>(static_cast<uint64_t>(hash) >> 56);
+    return tag == EMPTY_TAG ? 1 : tag;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+size_t BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::primaryIndex(size_t hash) const {
+    return hash & mask;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+size_t BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::altIndex(size_t index, uint8_t tag) const {
+    // XOR - инволюция: из любой из двух корзин получается другая
+    return (index ^ static_cast<size_t>(mixHash64(tag))) & mask;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+bool BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::findSlot(
+    const K& key, size_t hash, size_t& bucket, size_t& slot) const {
+    uint8_t tag = tagOf(hash);
+    size_t first = primaryIndex(hash);
+    size_t candidates[2] = {first, altIndex(first, tag)};
+    for (size_t index : candidates) {
+        const Bucket& b = buckets[index];
+        for (size_t i = 0; i < SlotsPerBucket; i++) {
+            if (b.tags[i] == tag && keyEqual(b.keys[i], key)) {
+                bucket = index;
+                slot = i;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+int BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::freeSlot(const Bucket& bucket) {
+    for (size_t i = 0; i < SlotsPerBucket; i++) {
+        if (bucket.tags[i] == EMPTY_TAG) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+bool BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::makeRoom(
+    size_t i1, size_t i2, size_t& bucket, size_t& slot) {
+    const size_t ROOT = std::numeric_limits<size_t>::max();
+    std::vector<PathNode> queue;
+    queue.push_back(PathNode{i1, ROOT, 0, 0});
+    if (i2 != i1) {
+        queue.push_back(PathNode{i2, ROOT, 0, 0});
+    }
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        PathNode node = queue[head];
+        int free = freeSlot(buckets[node.bucket]);
+        if (free >= 0) {
+            // Сдвиг с конца пути: каждый элемент переезжает в свою
+            // альтернативную корзину, освобождая слот для предыдущего
+            size_t target = head;
+            size_t targetSlot = static_cast<size_t>(free);
+            while (queue[target].parent != ROOT) {
+                const PathNode& step = queue[target];
+                Bucket& from = buckets[queue[step.parent].bucket];
+                Bucket& to = buckets[step.bucket];
+                to.tags[targetSlot] = from.tags[step.parentSlot];
+                to.keys[targetSlot] = std::move(from.keys[step.parentSlot]);
+                to.values[targetSlot] = std::move(from.values[step.parentSlot]);
+                from.tags[step.parentSlot] = EMPTY_TAG;
+                targetSlot = step.parentSlot;
+                target = step.parent;
+            }
+            bucket = queue[target].bucket;
+            slot = targetSlot;
+            return true;
+        }
+        if (node.depth == MAX_BFS_DEPTH) {
+            continue;
+        }
+
+        const Bucket& b = buckets[node.bucket];
+        for (size_t i = 0; i < SlotsPerBucket; i++) {
+            size_t next = altIndex(node.bucket, b.tags[i]);
+            // Корзины пути попарно различны, иначе сдвиг испортит
+            // ещё не перенесённые элементы
+            bool onPath = false;
+            for (size_t k = head; k != ROOT && !onPath; k = queue[k].parent) {
+                onPath = queue[k].bucket == next;
+            }
+            if (!onPath) {
+                queue.push_back(PathNode{next, head, i, node.depth + 1});
+            }
+        }
+    }
+    return false;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+void BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::place(
+    size_t bucket, size_t slot, uint8_t tag, const K& key, const V& value) {
+    Bucket& b = buckets[bucket];
+    b.tags[slot] = tag;
+    b.keys[slot] = key;
+    b.values[slot] = value;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+bool BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::tryRehash(size_t total) {
+    std::vector<Bucket> old(total);
+    old.swap(buckets);
+    size_t oldMask = mask;
+    mask = total - 1;
+
+    for (const Bucket& b : old) {
+        for (size_t i = 0; i < SlotsPerBucket; i++) {
+            if (b.tags[i] == EMPTY_TAG) continue;
+            size_t hash = hashOf(b.keys[i]);
+            uint8_t tag = tagOf(hash);
+            size_t first = primaryIndex(hash);
+            size_t bucket, slot;
+            if (!makeRoom(first, altIndex(first, tag), bucket, slot)) {
+                // Откат: элементы копировались, старая таблица цела
+                old.swap(buckets);
+                mask = oldMask;
+                return false;
+            }
+            place(bucket, slot, tag, b.keys[i], b.values[i]);
+        }
+    }
+    return true;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+void BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::grow() {
+    size_t total = (mask + 1) * 2;
+    while (!tryRehash(total)) {
+        total *= 2;
+        degenerateCheck(total);
+    }
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+void BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::degenerateCheck(size_t total) const {
+    // При нормальном хеше почти пустая таблица всегда находит место;
+    // иначе у слишком многих ключей совпадают обе корзины
+    if (static_cast<double>(count) < MIN_LOAD_FACTOR * static_cast<double>(total * SlotsPerBucket)) {
+        throw std::runtime_error("Слишком много ключей с одинаковым хешем");
+    }
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+void BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::put(const K& key, const V& value) {
+    size_t hash = hashOf(key);
+    size_t bucket, slot;
+    if (findSlot(key, hash, bucket, slot)) {
+        buckets[bucket].values[slot] = value;
+        return;
+    }
+
+    if (static_cast<double>(count + 1) > MAX_LOAD_FACTOR * static_cast<double>(bucketCount())) {
+        grow();
+    }
+    uint8_t tag = tagOf(hash);
+    while (true) {
+        size_t first = primaryIndex(hash);
+        if (makeRoom(first, altIndex(first, tag), bucket, slot)) {
+            break;
+        }
+        degenerateCheck(mask + 1);
+        grow();
+    }
+    place(bucket, slot, tag, key, value);
+    count++;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+V BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::get(const K& key) const {
+    size_t bucket, slot;
+    if (findSlot(key, hashOf(key), bucket, slot)) {
+        return buckets[bucket].values[slot];
+    }
+    throw std::runtime_error("Ключ не найден");
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+bool BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::contains(const K& key) const {
+    size_t bucket, slot;
+    return findSlot(key, hashOf(key), bucket, slot);
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+bool BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::remove(const K& key) {
+    size_t bucket, slot;
+    if (!findSlot(key, hashOf(key), bucket, slot)) {
+        return false;
+    }
+    Bucket& b = buckets[bucket];
+    b.tags[slot] = EMPTY_TAG;
+    b.keys[slot] = K();
+    b.values[slot] = V();
+    count--;
+    return true;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+void BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::clear() {
+    std::fill(buckets.begin(), buckets.end(), Bucket());
+    count = 0;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+size_t BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::size() const {
+    return count;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+bool BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::empty() const {
+    return count == 0;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+size_t BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::bucketCount() const {
+    return buckets.size() * SlotsPerBucket;
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+double BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::loadFactor() const {
+    return static_cast<double>(count) / static_cast<double>(bucketCount());
+}
+
+template<typename K, typename V, size_t SlotsPerBucket, typename Hash, typename KeyEqual>
+void BucketCuckooHashMap<K, V, SlotsPerBucket, Hash, KeyEqual>::print(std::ostream& os) const {
+    os << "BucketCuckooHashMap {\n";
+    for (size_t i = 0; i < buckets.size(); i++) {
+        for (size_t s = 0; s < SlotsPerBucket; s++) {
+            if (buckets[i].tags[s] != EMPTY_TAG) {
+                os << "  [" << i << ":" << s << "] " << buckets[i].keys[s]
+                   << " => " << buckets[i].values[s] << "\n";
+            }
+        }
+    }
+    os << "} (size: " << count << ")";
+}
+
+#endif
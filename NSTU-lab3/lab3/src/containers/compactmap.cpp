@@ -0,0 +1,303 @@
+#ifndef COMPACTMAP_CPP
+#define COMPACTMAP_CPP
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include "hash.h"
+
+// Реализация CompactStringMap
+
+inline CompactStringMap::CompactStringMap(size_t initialCapacity)
+    : mask(0), count(0), garbage(0) {
+    size_t capacity = 8;
+    while (static_cast<double>(capacity) * MAX_LOAD_FACTOR < static_cast<double>(initialCapacity)) {
+        capacity *= 2;
+    }
+    slots.assign(capacity, Slot{0, 0, EMPTY});
+    mask = capacity - 1;
+}
+
+inline uint64_t CompactStringMap::hashOf(std::string_view key) {
+    return static_cast<uint64_t>(std::hash<std::string_view>()(key));
+}
+
+inline uint32_t CompactStringMap::keyLength(uint32_t offset) const {
+    uint32_t length;
+    std::memcpy(&length, &arena[offset], sizeof(length));
+    return length & ~DEAD;
+}
+
+inline uint32_t CompactStringMap::valueLength(uint32_t offset) const {
+    uint32_t length;
+    std::memcpy(&length, &arena[offset + sizeof(uint32_t)], sizeof(length));
+    return length;
+}
+
+inline std::string_view CompactStringMap::keyAt(uint32_t offset) const {
+    return std::string_view(arena.data() + offset + HEADER_SIZE, keyLength(offset));
+}
+
+inline std::string_view CompactStringMap::valueAt(uint32_t offset) const {
+    return std::string_view(arena.data() + offset + HEADER_SIZE + keyLength(offset), valueLength(offset));
+}
+
+inline size_t CompactStringMap::recordSize(uint32_t offset) const {
+    return HEADER_SIZE + keyLength(offset) + valueLength(offset);
+}
+
+inline bool CompactStringMap::pointsIntoArena(std::string_view text) const {
+    std::less_equal<const char*> notAfter;
+    return !arena.empty() && !text.empty() &&
+           notAfter(arena.data(), text.data()) &&
+           notAfter(text.data(), arena.data() + arena.size() - 1);
+}
+
+inline uint32_t CompactStringMap::appendRecord(std::string_view key, std::string_view value) {
+    size_t offset = arena.size();
+    size_t total = HEADER_SIZE + key.size() + value.size();
+    // Смещения 32-битные: так слот занимает 16 байт
+    if (offset + total > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Арена CompactStringMap переполнена");
+    }
+    uint32_t keyLen = static_cast<uint32_t>(key.size());
+    uint32_t valueLen = static_cast<uint32_t>(value.size());
+    arena.resize(offset + total);
+    char* record = &arena[offset];
+    std::memcpy(record, &keyLen, sizeof(keyLen));
+    std::memcpy(record + sizeof(keyLen), &valueLen, sizeof(valueLen));
+    std::memcpy(record + HEADER_SIZE, key.data(), key.size());
+    std::memcpy(record + HEADER_SIZE + key.size(), value.data(), value.size());
+    return static_cast<uint32_t>(offset);
+}
+
+inline void CompactStringMap::killRecord(uint32_t offset) {
+    garbage += recordSize(offset);
+    uint32_t length = keyLength(offset) | DEAD;
+    std::memcpy(&arena[offset], &length, sizeof(length));
+}
+
+inline bool CompactStringMap::findSlot(std::string_view key, uint64_t hash, size_t& index) const {
+    index = hash & mask;
+    for (uint32_t dist = 0; dist <= mask; dist++) {
+        const Slot& slot = slots[index];
+        // Robin Hood: слот свободен или его элемент ближе к дому - ключа нет
+        if (slot.dist == EMPTY || slot.dist < dist) {
+            return false;
+        }
+        if (slot.hash == hash && keyAt(slot.offset) == key) {
+            return true;
+        }
+        index = (index + 1) & mask;
+    }
+    return false;
+}
+
+inline void CompactStringMap::insertSlot(Slot slot) {
+    size_t index = slot.hash & mask;
+    slot.dist = 0;
+    while (slots[index].dist != EMPTY) {
+        if (slots[index].dist < slot.dist) {
+            std::swap(slots[index], slot);
+        }
+        slot.dist++;
+        index = (index + 1) & mask;
+    }
+    slots[index] = slot;
+}
+
+inline void CompactStringMap::resize(size_t newCapacity) {
+    // Переносятся только 16-байтные слоты: хеш сохранён, арена не меняется
+    std::vector<Slot> oldSlots(newCapacity, Slot{0, 0, EMPTY});
+    oldSlots.swap(slots);
+    mask = newCapacity - 1;
+    for (const Slot& slot : oldSlots) {
+        if (slot.dist != EMPTY) {
+            insertSlot(slot);
+        }
+    }
+}
+
+inline void CompactStringMap::compact() {
+    std::vector<char> packed;
+    packed.reserve(arena.size() - garbage);
+    for (Slot& slot : slots) {
+        if (slot.dist == EMPTY) continue;
+        size_t size = recordSize(slot.offset);
+        size_t offset = packed.size();
+        packed.insert(packed.end(), arena.begin() + slot.offset, arena.begin() + slot.offset + size);
+        slot.offset = static_cast<uint32_t>(offset);
+    }
+    arena.swap(packed);
+    garbage = 0;
+}
+
+inline void CompactStringMap::put(std::string_view key, std::string_view value) {
+    // Аргументы могут указывать в саму арену (например, значение из find),
+    // а её рост перемещает данные - копируем заранее
+    if (pointsIntoArena(key) || pointsIntoArena(value)) {
+        std::string keyCopy(key), valueCopy(value);
+        put(keyCopy, valueCopy);
+        return;
+    }
+
+    uint64_t hash = hashOf(key);
+    size_t index;
+    if (findSlot(key, hash, index)) {
+        uint32_t offset = slots[index].offset;
+        if (valueLength(offset) == value.size()) {
+            std::memcpy(arena.data() + offset + HEADER_SIZE + key.size(), value.data(), value.size());
+            return;
+        }
+        killRecord(offset);
+        slots[index].offset = appendRecord(key, value);
+    } else {
+        if (static_cast<double>(count + 1) > MAX_LOAD_FACTOR * static_cast<double>(slots.size())) {
+            resize(slots.size() * 2);
+        }
+        insertSlot(Slot{hash, appendRecord(key, value), 0});
+        count++;
+    }
+    if (garbage > arena.size() / 2) {
+        compact();
+    }
+}
+
+inline std::string CompactStringMap::get(std::string_view key) const {
+    std::string_view value;
+    if (find(key, value)) {
+        return std::string(value);
+    }
+    throw std::runtime_error("Ключ не найден");
+}
+
+inline bool CompactStringMap::find(std::string_view key, std::string_view& value) const {
+    size_t index;
+    if (findSlot(key, hashOf(key), index)) {
+        value = valueAt(slots[index].offset);
+        return true;
+    }
+    return false;
+}
+
+inline bool CompactStringMap::contains(std::string_view key) const {
+    size_t index;
+    return findSlot(key, hashOf(key), index);
+}
+
+inline bool CompactStringMap::remove(std::string_view key) {
+    size_t index;
+    if (!findSlot(key, hashOf(key), index)) {
+        return false;
+    }
+    killRecord(slots[index].offset);
+
+    // Сдвиг хвоста кластера назад, как в HashMap
+    size_t next = (index + 1) & mask;
+    while (slots[next].dist != EMPTY && slots[next].dist > 0) {
+        slots[index] = slots[next];
+        slots[index].dist--;
+        index = next;
+        next = (next + 1) & mask;
+    }
+    slots[index].dist = EMPTY;
+    count--;
+
+    if (garbage > arena.size() / 2) {
+        compact();
+    }
+    return true;
+}
+
+inline void CompactStringMap::clear() {
+    std::fill(slots.begin(), slots.end(), Slot{0, 0, EMPTY});
+    arena.clear();
+    count = 0;
+    garbage = 0;
+}
+
+inline size_t CompactStringMap::size() const {
+    return count;
+}
+
+inline bool CompactStringMap::empty() const {
+    return count == 0;
+}
+
+inline size_t CompactStringMap::bucketCount() const {
+    return slots.size();
+}
+
+inline void CompactStringMap::reserve(size_t n) {
+    size_t capacity = slots.size();
+    while (static_cast<double>(capacity) * MAX_LOAD_FACTOR < static_cast<double>(n)) {
+        capacity *= 2;
+    }
+    if (capacity > slots.size()) {
+        resize(capacity);
+    }
+}
+
+inline size_t CompactStringMap::memoryUsage() const {
+    return slots.capacity() * sizeof(Slot) + arena.capacity();
+}
+
+inline size_t CompactStringMap::arenaBytes() const {
+    return arena.size();
+}
+
+template<typename F>
+void CompactStringMap::forEach(F f) const {
+    size_t offset = 0;
+    while (offset < arena.size()) {
+        uint32_t rawKeyLength;
+        std::memcpy(&rawKeyLength, &arena[offset], sizeof(rawKeyLength));
+        uint32_t current = static_cast<uint32_t>(offset);
+        if (!(rawKeyLength & DEAD)) {
+            f(keyAt(current), valueAt(current));
+        }
+        offset += recordSize(current);
+    }
+}
+
+inline void CompactStringMap::print(std::ostream& os) const {
+    os << "CompactStringMap {\n";
+    forEach([&os](std::string_view key, std::string_view value) {
+        os << "  " << key << " => " << value << "\n";
+    });
+    os << "} (size: " << count << ")";
+}
+
+// Бинарная сериализация: количество, затем пары ключ-значение (длина + данные)
+inline void CompactStringMap::saveToBinary(std::ofstream& out) const {
+    writeBinary(out, static_cast<uint32_t>(count));
+    forEach([&out](std::string_view key, std::string_view value) {
+        writeBinary(out, static_cast<uint32_t>(key.size()));
+        out.write(key.data(), key.size());
+        writeBinary(out, static_cast<uint32_t>(value.size()));
+        out.write(value.data(), value.size());
+    });
+}
+
+inline void CompactStringMap::loadFromBinary(std::ifstream& in) {
+    clear();
+    uint32_t sz = readUint32(in);
+    if (!in) {
+        throw std::runtime_error("Повреждённый снимок хеш-таблицы");
+    }
+    reserve(std::min<size_t>(sz, MAX_PRESIZED_ITEMS));
+    for (uint32_t i = 0; i < sz; i++) {
+        std::string key = readString(in);
+        std::string value = readString(in);
+        if (!in) {
+            // Частично загруженную таблицу не оставляем
+            clear();
+            throw std::runtime_error("Повреждённый снимок хеш-таблицы");
+        }
+        put(key, value);
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef CONCURRENT_CPP
+#define CONCURRENT_CPP
+
+#include <mutex>
+#include <shared_mutex>
+#include "hash.h"
+
+// Реализация ConcurrentHashMap
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+ConcurrentHashMap<K, V, Hash, KeyEqual>::ConcurrentHashMap(size_t shardCount, size_t initialCapacity) {
+    size_t count = 1;
+    while (count < shardCount) {
+        count *= 2;
+    }
+    shards.reset(new Shard[count]);
+    shardMask = count - 1;
+    reserve(initialCapacity);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+typename ConcurrentHashMap<K, V, Hash, KeyEqual>::Shard&
+ConcurrentHashMap<K, V, Hash, KeyEqual>::shardFor(const K& key) const {
+    // Сегмент выбирается по перемешанному хешу, внутри сегмента HashMap
+    // использует исходный - разбиение не портит распределение по слотам
+    return shards[mixHash64(static_cast<uint64_t>(hasher(key))) & shardMask];
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentHashMap<K, V, Hash, KeyEqual>::put(const K& key, const V& value) {
+    Shard& shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> guard(shard.lock);
+    shard.map.put(key, value);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V ConcurrentHashMap<K, V, Hash, KeyEqual>::get(const K& key) const {
+    V value;
+    if (tryGet(key, value)) {
+        return value;
+    }
+    throw std::runtime_error("Ключ не найден");
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentHashMap<K, V, Hash, KeyEqual>::tryGet(const K& key, V& value) const {
+    Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> guard(shard.lock);
+    const V* found = shard.map.find(key);
+    if (!found) {
+        return false;
+    }
+    value = *found;
+    return true;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentHashMap<K, V, Hash, KeyEqual>::contains(const K& key) const {
+    Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> guard(shard.lock);
+    return shard.map.contains(key);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentHashMap<K, V, Hash, KeyEqual>::remove(const K& key) {
+    Shard& shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> guard(shard.lock);
+    return shard.map.remove(key);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentHashMap<K, V, Hash, KeyEqual>::clear() {
+    for (size_t i = 0; i <= shardMask; i++) {
+        std::unique_lock<std::shared_mutex> guard(shards[i].lock);
+        shards[i].map.clear();
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ConcurrentHashMap<K, V, Hash, KeyEqual>::size() const {
+    size_t total = 0;
+    for (size_t i = 0; i <= shardMask; i++) {
+        std::shared_lock<std::shared_mutex> guard(shards[i].lock);
+        total += shards[i].map.size();
+    }
+    return total;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentHashMap<K, V, Hash, KeyEqual>::empty() const {
+    return size() == 0;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ConcurrentHashMap<K, V, Hash, KeyEqual>::shardCount() const {
+    return shardMask + 1;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentHashMap<K, V, Hash, KeyEqual>::reserve(size_t n) {
+    // Ключи распределены по сегментам равномерно; небольшой запас
+    // на неравномерность
+    size_t perShard = n / (shardMask + 1) + n / (4 * (shardMask + 1)) + 1;
+    for (size_t i = 0; i <= shardMask; i++) {
+        std::unique_lock<std::shared_mutex> guard(shards[i].lock);
+        shards[i].map.reserve(perShard);
+    }
+}
+
+#endif
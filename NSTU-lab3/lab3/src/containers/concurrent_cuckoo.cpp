@@ -0,0 +1,480 @@
+#ifndef CONCURRENT_CUCKOO_CPP
+#define CONCURRENT_CUCKOO_CPP
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include "hash.h"
+
+// Реализация ConcurrentCuckooHashMap
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::Bucket::Bucket() {
+    for (size_t i = 0; i < SLOTS_PER_BUCKET; i++) {
+        tags[i].store(EMPTY_TAG, std::memory_order_relaxed);
+        keys[i].store(K(), std::memory_order_relaxed);
+        values[i].store(V(), std::memory_order_relaxed);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::Table::Table(size_t bucketCount)
+    : buckets(new Bucket[bucketCount]), mask(bucketCount - 1) {}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::ConcurrentCuckooHashMap(size_t initialCapacity)
+    : stripes(new Stripe[STRIPES]), count(0) {
+    size_t total = 2;
+    while (total * SLOTS_PER_BUCKET < initialCapacity) {
+        total *= 2;
+    }
+    current.store(new Table(total), std::memory_order_release);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::~ConcurrentCuckooHashMap() {
+    // Параллельных операций при разрушении быть не должно
+    delete current.load(std::memory_order_acquire);
+    for (const Retired& item : retired) {
+        delete item.table;
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::hashOf(const K& key) const {
+    return static_cast<size_t>(mixHash64(static_cast<uint64_t>(hasher(key))));
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+uint8_t ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::tagOf(size_t hash) {
+    uint8_t tag = static_cast<uint8_t>(static_cast<uint64_t>(hash) >> 56);
+    return tag == EMPTY_TAG ? 1 : tag;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::altIndex(const Table* t, size_t index, uint8_t tag) {
+    return (index ^ static_cast<size_t>(mixHash64(tag))) & t->mask;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::stripeOf(size_t bucket) {
+    return bucket & (STRIPES - 1);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+uint64_t ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::stableVersion(size_t stripe) const {
+    while (true) {
+        uint64_t version = stripes[stripe].version.load(std::memory_order_acquire);
+        if (!(version & 1)) {
+            return version;
+        }
+        std::this_thread::yield();
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::lockStripe(size_t stripe) {
+    std::atomic<uint64_t>& version = stripes[stripe].version;
+    while (true) {
+        uint64_t observed = version.load(std::memory_order_relaxed);
+        if (!(observed & 1) &&
+            version.compare_exchange_weak(observed, observed + 1,
+                                          std::memory_order_acquire, std::memory_order_relaxed)) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    // Нечётная версия становится видна раньше любых изменений слотов:
+    // парный барьер - в findOptimistic
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::unlockStripe(size_t stripe) {
+    stripes[stripe].version.fetch_add(1, std::memory_order_release);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::lockPair(size_t b1, size_t b2) {
+    // Единый порядок захвата исключает взаимную блокировку писателей
+    size_t first = std::min(stripeOf(b1), stripeOf(b2));
+    size_t second = std::max(stripeOf(b1), stripeOf(b2));
+    lockStripe(first);
+    if (second != first) {
+        lockStripe(second);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::unlockPair(size_t b1, size_t b2) {
+    size_t first = std::min(stripeOf(b1), stripeOf(b2));
+    size_t second = std::max(stripeOf(b1), stripeOf(b2));
+    if (second != first) {
+        unlockStripe(second);
+    }
+    unlockStripe(first);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+int ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::findKey(
+    const Bucket& bucket, uint8_t tag, const K& key, const KeyEqual& equal) {
+    for (size_t i = 0; i < SLOTS_PER_BUCKET; i++) {
+        if (bucket.tags[i].load(std::memory_order_relaxed) == tag &&
+            equal(bucket.keys[i].load(std::memory_order_relaxed), key)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+int ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::freeSlot(const Bucket& bucket) {
+    for (size_t i = 0; i < SLOTS_PER_BUCKET; i++) {
+        if (bucket.tags[i].load(std::memory_order_relaxed) == EMPTY_TAG) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::findOptimistic(const K& key, V* value) const {
+    size_t hash = hashOf(key);
+    uint8_t tag = tagOf(hash);
+    EpochGuard guard;
+    while (true) {
+        const Table* t = current.load(std::memory_order_acquire);
+        size_t b1 = hash & t->mask;
+        size_t b2 = altIndex(t, b1, tag);
+        size_t s1 = stripeOf(b1), s2 = stripeOf(b2);
+        uint64_t v1 = stableVersion(s1);
+        uint64_t v2 = stableVersion(s2);
+
+        bool found = false;
+        V result{};
+        for (size_t b : {b1, b2}) {
+            const Bucket& bucket = t->buckets[b];
+            int i = findKey(bucket, tag, key, keyEqual);
+            if (i >= 0) {
+                result = bucket.values[i].load(std::memory_order_relaxed);
+                found = true;
+                break;
+            }
+        }
+
+        // Прочитанное согласовано, если за время чтения ни одна из двух
+        // полос не захватывалась и таблицу не заменили
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (stripes[s1].version.load(std::memory_order_relaxed) == v1 &&
+            stripes[s2].version.load(std::memory_order_relaxed) == v2 &&
+            current.load(std::memory_order_relaxed) == t) {
+            if (found && value) {
+                *value = result;
+            }
+            return found;
+        }
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::findPath(
+    const Table* t, size_t b1, size_t b2, std::vector<Move>& path) {
+    struct Node {
+        size_t bucket;
+        size_t parent;
+        size_t parentSlot;
+        uint8_t tag;        // отпечаток элемента, переезжающего сюда из родителя
+        size_t depth;
+    };
+    const size_t ROOT = std::numeric_limits<size_t>::max();
+    std::vector<Node> queue;
+    queue.push_back(Node{b1, ROOT, 0, EMPTY_TAG, 0});
+    if (b2 != b1) {
+        queue.push_back(Node{b2, ROOT, 0, EMPTY_TAG, 0});
+    }
+
+    // Поиск идёт без блокировок: найденный путь может устареть,
+    // это проверит applyMove
+    for (size_t head = 0; head < queue.size(); head++) {
+        Node node = queue[head];
+        if (freeSlot(t->buckets[node.bucket]) >= 0) {
+            path.clear();
+            for (size_t k = head; queue[k].parent != ROOT; k = queue[k].parent) {
+                const Node& step = queue[k];
+                path.push_back(Move{queue[step.parent].bucket, step.parentSlot, step.bucket, step.tag});
+            }
+            return true;
+        }
+        if (node.depth == MAX_BFS_DEPTH) {
+            continue;
+        }
+        for (size_t i = 0; i < SLOTS_PER_BUCKET; i++) {
+            uint8_t tag = t->buckets[node.bucket].tags[i].load(std::memory_order_relaxed);
+            if (tag == EMPTY_TAG) {
+                continue;
+            }
+            size_t next = altIndex(t, node.bucket, tag);
+            bool onPath = false;
+            for (size_t k = head; k != ROOT && !onPath; k = queue[k].parent) {
+                onPath = queue[k].bucket == next;
+            }
+            if (!onPath) {
+                queue.push_back(Node{next, head, i, tag, node.depth + 1});
+            }
+        }
+    }
+    return false;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::applyMove(Table* t, const Move& move) {
+    Bucket& from = t->buckets[move.from];
+    Bucket& to = t->buckets[move.to];
+    // Вторая корзина зависит только от корзины и отпечатка, поэтому
+    // любой элемент с тем же отпечатком в этом слоте переезжает туда же
+    if (from.tags[move.slot].load(std::memory_order_relaxed) != move.tag) {
+        return false;
+    }
+    int free = freeSlot(to);
+    if (free < 0) {
+        return false;
+    }
+    to.keys[free].store(from.keys[move.slot].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    to.values[free].store(from.values[move.slot].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    to.tags[free].store(move.tag, std::memory_order_relaxed);
+    from.tags[move.slot].store(EMPTY_TAG, std::memory_order_relaxed);
+    return true;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::placePrivate(
+    Table* t, size_t hash, const K& key, const V& value) {
+    uint8_t tag = tagOf(hash);
+    size_t b1 = hash & t->mask;
+    size_t b2 = altIndex(t, b1, tag);
+    std::vector<Move> path;
+    if (!findPath(t, b1, b2, path)) {
+        return false;
+    }
+    for (const Move& move : path) {
+        applyMove(t, move);
+    }
+    for (size_t b : {b1, b2}) {
+        Bucket& bucket = t->buckets[b];
+        int i = freeSlot(bucket);
+        if (i >= 0) {
+            bucket.keys[i].store(key, std::memory_order_relaxed);
+            bucket.values[i].store(value, std::memory_order_relaxed);
+            bucket.tags[i].store(tag, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::grow(Table* expected) {
+    std::lock_guard<std::mutex> guard(resizeLock);
+    Table* old = current.load(std::memory_order_acquire);
+    if (old != expected) {
+        return;     // таблицу уже увеличил другой писатель
+    }
+    for (size_t s = 0; s < STRIPES; s++) {
+        lockStripe(s);
+    }
+
+    size_t total = (old->mask + 1) * 2;
+    Table* bigger = nullptr;
+    while (!bigger) {
+        bigger = new Table(total);
+        for (size_t b = 0; b <= old->mask && bigger; b++) {
+            const Bucket& bucket = old->buckets[b];
+            for (size_t i = 0; i < SLOTS_PER_BUCKET; i++) {
+                if (bucket.tags[i].load(std::memory_order_relaxed) == EMPTY_TAG) continue;
+                K key = bucket.keys[i].load(std::memory_order_relaxed);
+                if (!placePrivate(bigger, hashOf(key), key, bucket.values[i].load(std::memory_order_relaxed))) {
+                    delete bigger;
+                    bigger = nullptr;
+                    total *= 2;
+                    break;
+                }
+            }
+        }
+    }
+
+    current.store(bigger, std::memory_order_release);
+    for (size_t s = 0; s < STRIPES; s++) {
+        unlockStripe(s);
+    }
+    retire(old);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::retire(Table* t) {
+    EpochDomain& domain = EpochDomain::instance();
+    retired.push_back(Retired{t, domain.currentEpoch()});
+    domain.advance();
+    reclaim();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::reclaim() {
+    // Парный барьер к EpochDomain::enter(), как в ReadMostlyHashMap
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t oldestReader = EpochDomain::instance().minActiveEpoch();
+    size_t kept = 0;
+    for (const Retired& item : retired) {
+        if (item.epoch < oldestReader) {
+            delete item.table;
+        } else {
+            retired[kept++] = item;
+        }
+    }
+    retired.resize(kept);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::get(const K& key) const {
+    V value;
+    if (findOptimistic(key, &value)) {
+        return value;
+    }
+    throw std::runtime_error("Ключ не найден");
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::tryGet(const K& key, V& value) const {
+    return findOptimistic(key, &value);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::contains(const K& key) const {
+    return findOptimistic(key, nullptr);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::put(const K& key, const V& value) {
+    size_t hash = hashOf(key);
+    uint8_t tag = tagOf(hash);
+    EpochGuard guard;
+    std::vector<Move> path;
+    while (true) {
+        Table* t = current.load(std::memory_order_acquire);
+        size_t b1 = hash & t->mask;
+        size_t b2 = altIndex(t, b1, tag);
+        lockPair(b1, b2);
+        // Пока захвачена хоть одна полоса, рост таблицу не заменит
+        if (current.load(std::memory_order_acquire) != t) {
+            unlockPair(b1, b2);
+            continue;
+        }
+
+        for (size_t b : {b1, b2}) {
+            Bucket& bucket = t->buckets[b];
+            int i = findKey(bucket, tag, key, keyEqual);
+            if (i >= 0) {
+                bucket.values[i].store(value, std::memory_order_relaxed);
+                unlockPair(b1, b2);
+                return;
+            }
+        }
+        for (size_t b : {b1, b2}) {
+            Bucket& bucket = t->buckets[b];
+            int i = freeSlot(bucket);
+            if (i >= 0) {
+                bucket.keys[i].store(key, std::memory_order_relaxed);
+                bucket.values[i].store(value, std::memory_order_relaxed);
+                bucket.tags[i].store(tag, std::memory_order_relaxed);
+                count.fetch_add(1, std::memory_order_relaxed);
+                unlockPair(b1, b2);
+                return;
+            }
+        }
+        unlockPair(b1, b2);
+
+        if (!findPath(t, b1, b2, path)) {
+            // При нормальном хеше путь находится почти всегда, пока таблица
+            // не заполнена; иначе у слишком многих ключей одни и те же корзины
+            if (count.load(std::memory_order_relaxed) < (t->mask + 1) * SLOTS_PER_BUCKET / 4) {
+                throw std::runtime_error("Слишком много ключей с одинаковым хешем");
+            }
+            grow(t);
+            continue;
+        }
+        // Сдвиг по пути с конца; если другой писатель успел изменить
+        // какую-то корзину, путь ищется заново
+        for (const Move& move : path) {
+            lockPair(move.from, move.to);
+            bool moved = current.load(std::memory_order_acquire) == t && applyMove(t, move);
+            unlockPair(move.from, move.to);
+            if (!moved) {
+                break;
+            }
+        }
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::remove(const K& key) {
+    size_t hash = hashOf(key);
+    uint8_t tag = tagOf(hash);
+    EpochGuard guard;
+    while (true) {
+        Table* t = current.load(std::memory_order_acquire);
+        size_t b1 = hash & t->mask;
+        size_t b2 = altIndex(t, b1, tag);
+        lockPair(b1, b2);
+        if (current.load(std::memory_order_acquire) != t) {
+            unlockPair(b1, b2);
+            continue;
+        }
+        bool removed = false;
+        for (size_t b : {b1, b2}) {
+            Bucket& bucket = t->buckets[b];
+            int i = findKey(bucket, tag, key, keyEqual);
+            if (i >= 0) {
+                bucket.tags[i].store(EMPTY_TAG, std::memory_order_relaxed);
+                count.fetch_sub(1, std::memory_order_relaxed);
+                removed = true;
+                break;
+            }
+        }
+        unlockPair(b1, b2);
+        return removed;
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::clear() {
+    std::lock_guard<std::mutex> guard(resizeLock);
+    for (size_t s = 0; s < STRIPES; s++) {
+        lockStripe(s);
+    }
+    Table* old = current.load(std::memory_order_relaxed);
+    current.store(new Table(old->mask + 1), std::memory_order_release);
+    count.store(0, std::memory_order_relaxed);
+    for (size_t s = 0; s < STRIPES; s++) {
+        unlockStripe(s);
+    }
+    retire(old);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::empty() const {
+    return size() == 0;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ConcurrentCuckooHashMap<K, V, Hash, KeyEqual>::bucketCount() const {
+    EpochGuard guard;
+    return (current.load(std::memory_order_acquire)->mask + 1) * SLOTS_PER_BUCKET;
+}
+
+#endif
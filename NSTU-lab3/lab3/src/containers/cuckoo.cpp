@@ -1,161 +1,278 @@
 #ifndef CUCKOO_CPP
 #define CUCKOO_CPP
 
+#include <algorithm>
 #include "hash.h"
 
-template<typename K, typename V>
-CuckooHashMap<K, V>::Entry::Entry() : occupied(false) {}
+template<typename K, typename V, typename Hash, typename KeyEqual>
+CuckooHashMap<K, V, Hash, KeyEqual>::Entry::Entry() : hash{0, 0}, occupied(false) {}
 
-template<typename K, typename V>
-CuckooHashMap<K, V>::Entry::Entry(const K& k, const V& v) : key(k), value(v), occupied(true) {}
+template<typename K, typename V, typename Hash, typename KeyEqual>
+CuckooHashMap<K, V, Hash, KeyEqual>::Entry::Entry(const K& k, const V& v, Hash128 h)
+    : key(k), value(v), hash(h), occupied(true) {}
 
-template<typename K, typename V>
-CuckooHashMap<K, V>::CuckooHashMap(size_t initialCapacity) 
-    : capacity(initialCapacity), count(0) {
+template<typename K, typename V, typename Hash, typename KeyEqual>
+CuckooHashMap<K, V, Hash, KeyEqual>::CuckooHashMap(size_t initialCapacity)
+    : capacity(std::max<size_t>(initialCapacity, 1)), count(0) {
     table1.resize(capacity);
     table2.resize(capacity);
+    setSeed(0);
 }
 
-template<typename K, typename V>
-size_t CuckooHashMap<K, V>::hash1(const K& key) const {
-    std::hash<K> hasher;
-    return hasher(key) % capacity;
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::setSeed(uint64_t newGeneration) {
+    generation = newGeneration;
+    seed = mixHash64(generation + 1);
 }
 
-template<typename K, typename V>
-size_t CuckooHashMap<K, V>::hash2(const K& key) const {
-    std::hash<K> hasher;
-    return (hasher(key) / capacity) % capacity;
+template<typename K, typename V, typename Hash, typename KeyEqual>
+Hash128 CuckooHashMap<K, V, Hash, KeyEqual>::hashOf(const K& key) const {
+    if constexpr (IsSeededHash<Hash, K>::value) {
+        return hasher(key, seed);
+    } else {
+        // Ключи с равным size_t-хешем не различит никакой seed
+        uint64_t h = static_cast<uint64_t>(hasher(key));
+        return wyHash128(&h, sizeof(h), seed);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t CuckooHashMap<K, V, Hash, KeyEqual>::index1(const Hash128& hash) const {
+    return static_cast<size_t>(hash.first % capacity);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t CuckooHashMap<K, V, Hash, KeyEqual>::index2(const Hash128& hash) const {
+    return static_cast<size_t>(hash.second % capacity);
 }
 
-template<typename K, typename V>
-bool CuckooHashMap<K, V>::insertInternal(const K& key, const V& value, int iterations) {
-    if (iterations >= MAX_ITERATIONS) {
-        throw std::runtime_error("CuckooHashMap: слишком много итераций, требуется рехеширование");
+template<typename K, typename V, typename Hash, typename KeyEqual>
+const typename CuckooHashMap<K, V, Hash, KeyEqual>::Entry*
+CuckooHashMap<K, V, Hash, KeyEqual>::findEntry(const K& key, const Hash128& hash) const {
+    const Entry& first = table1[index1(hash)];
+    if (first.occupied && first.hash == hash && keyEqual(first.key, key)) {
+        return &first;
     }
-    
-    size_t idx1 = hash1(key);
-    
-    if (!table1[idx1].occupied) {
-        table1[idx1] = Entry(key, value);
-        return true;
+    const Entry& second = table2[index2(hash)];
+    if (second.occupied && second.hash == hash && keyEqual(second.key, key)) {
+        return &second;
+    }
+    for (const Entry& entry : stash) {
+        if (entry.hash == hash && keyEqual(entry.key, key)) {
+            return &entry;
+        }
     }
-    
-    if (table1[idx1].key == key) {
-        table1[idx1].value = value;
+    return nullptr;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool CuckooHashMap<K, V, Hash, KeyEqual>::insertEntry(Entry& entry) {
+    entry.occupied = true;
+    Entry& first = table1[index1(entry.hash)];
+    if (!first.occupied) {
+        first = std::move(entry);
         return true;
     }
-    
-    K oldKey = table1[idx1].key;
-    V oldValue = table1[idx1].value;
-    table1[idx1] = Entry(key, value);
-    
-    size_t idx2 = hash2(oldKey);
-    
-    if (!table2[idx2].occupied) {
-        table2[idx2] = Entry(oldKey, oldValue);
+    Entry& second = table2[index2(entry.hash)];
+    if (!second.occupied) {
+        second = std::move(entry);
         return true;
     }
-    
-    if (table2[idx2].key == oldKey) {
-        table2[idx2].value = oldValue;
+
+    // Итеративное вытеснение: выселенный элемент идёт в свой слот другой таблицы
+    bool toFirst = true;
+    for (int kick = 0; kick < MAX_KICKS; kick++) {
+        Entry& slot = toFirst ? table1[index1(entry.hash)] : table2[index2(entry.hash)];
+        if (!slot.occupied) {
+            slot = std::move(entry);
+            return true;
+        }
+        std::swap(slot, entry);
+        toFirst = !toFirst;
+    }
+
+    if (stash.size() < STASH_SIZE) {
+        stash.push_back(std::move(entry));
         return true;
     }
-    
-    K nextKey = table2[idx2].key;
-    V nextValue = table2[idx2].value;
-    table2[idx2] = Entry(oldKey, oldValue);
-    
-    return insertInternal(nextKey, nextValue, iterations + 1);
-}
-
-template<typename K, typename V>
-void CuckooHashMap<K, V>::put(const K& key, const V& value) {
-    if (count >= capacity * 2) {
-        throw std::runtime_error("CuckooHashMap заполнена");
-    }
-    
-    if (contains(key)) {
-        size_t idx1 = hash1(key);
-        size_t idx2 = hash2(key);
-        
-        if (table1[idx1].occupied && table1[idx1].key == key) {
-            table1[idx1].value = value;
-        } else if (table2[idx2].occupied && table2[idx2].key == key) {
-            table2[idx2].value = value;
+    return false;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool CuckooHashMap<K, V, Hash, KeyEqual>::tryRebuild(size_t newCapacity, uint64_t newGeneration, const Entry* extra) {
+    std::vector<Entry> old1(newCapacity), old2(newCapacity), oldStash;
+    old1.swap(table1);
+    old2.swap(table2);
+    oldStash.swap(stash);
+    size_t oldCapacity = capacity;
+    uint64_t oldGeneration = generation;
+    capacity = newCapacity;
+    setSeed(newGeneration);
+    bool reseeded = newGeneration != oldGeneration;
+
+    bool placed = true;
+    auto place = [this, &placed, reseeded](const Entry& source) {
+        Entry entry = source;
+        if (reseeded) {
+            entry.hash = hashOf(entry.key);
+        }
+        placed = placed && insertEntry(entry);
+    };
+    for (const auto* t : {&old1, &old2, &oldStash}) {
+        for (const Entry& entry : *t) {
+            if (entry.occupied) place(entry);
         }
-        return;
     }
-    
-    if (insertInternal(key, value, 0)) {
-        count++;
+    if (extra) place(*extra);
+
+    if (!placed) {
+        // Откат: старые таблицы целы, элементы копировались
+        old1.swap(table1);
+        old2.swap(table2);
+        oldStash.swap(stash);
+        capacity = oldCapacity;
+        setSeed(oldGeneration);
     }
+    return placed;
 }
 
-template<typename K, typename V>
-V CuckooHashMap<K, V>::get(const K& key) const {
-    size_t idx1 = hash1(key);
-    size_t idx2 = hash2(key);
-    
-    if (table1[idx1].occupied && table1[idx1].key == key) {
-        return table1[idx1].value;
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::rebuild(size_t newCapacity, const Entry* extra) {
+    // Рост сначала пробуется с прежним seed'ом - без перехеширования ключей
+    uint64_t nextGeneration = extra ? generation + 1 : generation;
+    for (int attempt = 0; attempt < MAX_REBUILD_ATTEMPTS; attempt++) {
+        if (attempt > 0 && attempt % RESEEDS_PER_SIZE == 0) {
+            newCapacity *= 2;
+        }
+        if (tryRebuild(newCapacity, nextGeneration++, extra)) {
+            return;
+        }
     }
-    if (table2[idx2].occupied && table2[idx2].key == key) {
-        return table2[idx2].value;
+    // Ключи с совпадающими size_t-хешами не разделяют никакие seed'ы:
+    // такой элемент остаётся в стэше сверх лимита
+    if (extra) {
+        stash.push_back(*extra);
     }
-    throw std::runtime_error("Ключ не найден");
 }
 
-template<typename K, typename V>
-bool CuckooHashMap<K, V>::contains(const K& key) const {
-    size_t idx1 = hash1(key);
-    size_t idx2 = hash2(key);
-    
-    return (table1[idx1].occupied && table1[idx1].key == key) ||
-           (table2[idx2].occupied && table2[idx2].key == key);
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::drainStash() {
+    for (size_t i = 0; i < stash.size(); ) {
+        Entry& first = table1[index1(stash[i].hash)];
+        Entry& second = table2[index2(stash[i].hash)];
+        Entry* slot = !first.occupied ? &first : (!second.occupied ? &second : nullptr);
+        if (slot) {
+            *slot = std::move(stash[i]);
+            stash.erase(stash.begin() + i);
+        } else {
+            i++;
+        }
+    }
 }
 
-template<typename K, typename V>
-bool CuckooHashMap<K, V>::remove(const K& key) {
-    size_t idx1 = hash1(key);
-    size_t idx2 = hash2(key);
-    
-    if (table1[idx1].occupied && table1[idx1].key == key) {
-        table1[idx1].occupied = false;
-        count--;
-        return true;
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::put(const K& key, const V& value) {
+    Hash128 hash = hashOf(key);
+    Entry* existing = const_cast<Entry*>(findEntry(key, hash));
+    if (existing) {
+        existing->value = value;
+        return;
     }
-    if (table2[idx2].occupied && table2[idx2].key == key) {
-        table2[idx2].occupied = false;
-        count--;
-        return true;
+
+    uint64_t oldGeneration = generation;
+    if (static_cast<double>(count + 1) > MAX_LOAD_FACTOR * static_cast<double>(2 * capacity)) {
+        rebuild(capacity * 2, nullptr);
+        if (generation != oldGeneration) {
+            hash = hashOf(key);
+        }
     }
-    return false;
+
+    Entry entry(key, value, hash);
+    if (!insertEntry(entry)) {
+        // Цикл вытеснений при полном стэше: entry - вытесненный бездомный элемент
+        rebuild(capacity, &entry);
+    }
+    count++;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V CuckooHashMap<K, V, Hash, KeyEqual>::get(const K& key) const {
+    const Entry* entry = findEntry(key, hashOf(key));
+    if (entry) {
+        return entry->value;
+    }
+    throw std::runtime_error("Ключ не найден");
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool CuckooHashMap<K, V, Hash, KeyEqual>::contains(const K& key) const {
+    return findEntry(key, hashOf(key)) != nullptr;
 }
 
-template<typename K, typename V>
-void CuckooHashMap<K, V>::clear() {
-    for (auto& entry : table1) {
-        entry.occupied = false;
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool CuckooHashMap<K, V, Hash, KeyEqual>::remove(const K& key) {
+    Entry* entry = const_cast<Entry*>(findEntry(key, hashOf(key)));
+    if (!entry) {
+        return false;
+    }
+
+    count--;
+    for (size_t i = 0; i < stash.size(); i++) {
+        if (&stash[i] == entry) {
+            stash.erase(stash.begin() + i);
+            return true;
+        }
     }
-    for (auto& entry : table2) {
-        entry.occupied = false;
+    *entry = Entry();
+    if (!stash.empty()) {
+        drainStash();
     }
+    return true;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::clear() {
+    std::fill(table1.begin(), table1.end(), Entry());
+    std::fill(table2.begin(), table2.end(), Entry());
+    stash.clear();
     count = 0;
 }
 
-template<typename K, typename V>
-size_t CuckooHashMap<K, V>::size() const {
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t CuckooHashMap<K, V, Hash, KeyEqual>::size() const {
     return count;
 }
 
-template<typename K, typename V>
-bool CuckooHashMap<K, V>::empty() const {
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool CuckooHashMap<K, V, Hash, KeyEqual>::empty() const {
     return count == 0;
 }
 
-template<typename K, typename V>
-void CuckooHashMap<K, V>::print(std::ostream& os) const {
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t CuckooHashMap<K, V, Hash, KeyEqual>::bucketCount() const {
+    return 2 * capacity;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+double CuckooHashMap<K, V, Hash, KeyEqual>::loadFactor() const {
+    return static_cast<double>(count) / static_cast<double>(2 * capacity);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t CuckooHashMap<K, V, Hash, KeyEqual>::stashSize() const {
+    return stash.size();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::reserve(size_t n) {
+    size_t needed = static_cast<size_t>(static_cast<double>(n) / (2 * MAX_LOAD_FACTOR)) + 1;
+    if (needed > capacity) {
+        rebuild(needed, nullptr);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::print(std::ostream& os) const {
     os << "CuckooHashMap {\n  Table 1:\n";
     for (size_t i = 0; i < capacity; i++) {
         if (table1[i].occupied) {
@@ -168,7 +285,51 @@ void CuckooHashMap<K, V>::print(std::ostream& os) const {
             os << "    [" << i << "] " << table2[i].key << " => " << table2[i].value << "\n";
         }
     }
+    if (!stash.empty()) {
+        os << "  Stash:\n";
+        for (const Entry& entry : stash) {
+            os << "    " << entry.key << " => " << entry.value << "\n";
+        }
+    }
     os << "} (size: " << count << ")";
 }
 
+// Бинарная сериализация: количество, затем пары ключ-значение
+// из обеих таблиц и стэша
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::saveToBinary(std::ofstream& out) const {
+    uint32_t sz = static_cast<uint32_t>(count);
+    out.write(reinterpret_cast<const char*>(&sz), sizeof(sz));
+    for (const auto* t : {&table1, &table2, &stash}) {
+        for (const Entry& entry : *t) {
+            if (!entry.occupied) continue;
+            writeValue(out, entry.key);
+            writeValue(out, entry.value);
+        }
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void CuckooHashMap<K, V, Hash, KeyEqual>::loadFromBinary(std::ifstream& in) {
+    clear();
+    uint32_t sz = 0;
+    in.read(reinterpret_cast<char*>(&sz), sizeof(sz));
+    if (!in) {
+        throw std::runtime_error("Повреждённый снимок хеш-таблицы");
+    }
+    reserve(std::min<size_t>(sz, MAX_PRESIZED_ITEMS));
+    for (uint32_t i = 0; i < sz; i++) {
+        K key;
+        V value;
+        readValue(in, key);
+        readValue(in, value);
+        if (!in) {
+            // Частично загруженную таблицу не оставляем
+            clear();
+            throw std::runtime_error("Повреждённый снимок хеш-таблицы");
+        }
+        put(key, value);
+    }
+}
+
 #endif
@@ -8,37 +8,117 @@
 #include <vector>
 #include <cstdint>
 #include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include "../binary_serialization.h"
+#include "hash_policies.h"
 
-template<typename K, typename V>
+// Хеш-таблица с открытой адресацией. Стратегии задаются на этапе компиляции:
+// Hash и KeyEqual - хеш-функция и сравнение ключей, Probing - схема
+// пробирования (RobinHoodProbing, LinearProbing), Reduction - отображение
+// хеша в слот (PrimeModuloReduction, PowerOfTwoReduction, FastRangeReduction).
+// Если Hash и KeyEqual прозрачны (по умолчанию для строк), find/contains
+// принимают любой совместимый ключ, например std::string_view
+template<typename K, typename V,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = std::equal_to<>,
+         typename Probing = RobinHoodProbing,
+         typename Reduction = PrimeModuloReduction>
 class HashMap {
+public:
+    // FULL_REHASH переносит все элементы за один put(), INCREMENTAL_REHASH
+    // держит старую и новую таблицы одновременно и переносит порцию
+    // слотов (от REHASH_STEP до конца кластера) за каждую изменяющую операцию
+    enum RehashMode { FULL_REHASH, INCREMENTAL_REHASH };
+
 private:
     static const size_t DEFAULT_CAPACITY = 101;
+    static constexpr size_t MIN_CAPACITY = 3;
+    static constexpr size_t REHASH_STEP = 64;
+    // Вставка, сдвинувшая элемент дальше этого расстояния, вызывает рост
+    // таблицы (если заполненность не слишком мала)
+    static constexpr uint32_t MAX_PROBE_DISTANCE = 32;
+    static constexpr double DEFAULT_MAX_LOAD_FACTOR = 0.75;
+    // Ключей в одной порции getMany/putMany: их домашние слоты
+    // предвыбираются вместе, и промахи кэша перекрываются
+    static constexpr size_t PREFETCH_BATCH = 16;
+    // dist - расстояние от домашнего слота. Полный хеш ключа хранится в
+    // записи: несовпадающие слоты отсекаются без сравнения ключей,
+    // а рост таблицы не вычисляет хеши заново
     struct Entry {
         K key;
         V value;
+        size_t hash;
+        uint32_t dist;
         bool occupied;
         Entry();
-        Entry(const K& k, const V& v);
+        Entry(const K& k, const V& v, size_t h);
     };
     std::vector<Entry> table;
     size_t capacity;
     size_t count;
+    double maxLoad;
+    RehashMode mode;
+    Hash hasher;
+    KeyEqual keyEqual;
+    // Таблица, из которой идёт инкрементальный перенос. Перенос начинается
+    // с пустого слота migrateFrom и останавливается только на пустых слотах,
+    // поэтому оставшиеся в oldTable кластеры всегда целые
+    std::vector<Entry> oldTable;
+    size_t migrateFrom;
+    size_t migrated;
     
-    size_t hash1(const K& key) const;
-    size_t hash2(const K& key) const;
-    bool findIndex(const K& key, size_t& index) const;
+    template<typename Q>
+    using EnableLookup = std::enable_if_t<IsTransparentLookup<Hash, KeyEqual, Q>::value>;
+    
+    // Ключ хешируется один раз за операцию, дальше передаётся готовый хеш.
+    // Q - K или прозрачно сравнимый с ним тип
+    template<typename Q>
+    size_t hashOf(const Q& key) const;
+    template<typename Q>
+    bool findIndex(const std::vector<Entry>& t, const Q& key, size_t hash, size_t& index) const;
+    // Поиск в обеих таблицах; inOld = true, если ключ ещё не перенесён
+    template<typename Q>
+    bool locate(const Q& key, size_t hash, bool& inOld, size_t& index) const;
+    template<typename Q>
+    const V* findValue(const Q& key) const;
+    // put() с уже вычисленным хешем
+    void putHashed(const K& key, const V& value, size_t hash);
+    // Предвыборка домашнего слота хеша в t
+    void prefetchSlot(const std::vector<Entry>& t, size_t hash) const;
+    // Вставка заведомо отсутствующего ключа; возвращает наибольшее
+    // расстояние, на которое пришлось сдвинуть какой-либо элемент
+    uint32_t insertEntry(std::vector<Entry>& t, Entry entry);
+    // Удаление со сдвигом хвоста кластера назад (без надгробий)
+    void eraseAt(std::vector<Entry>& t, size_t index);
+    // Минимальная ёмкость, при которой n элементов не превышают maxLoad
+    size_t capacityFor(size_t n) const;
+    void grow();
+    void rehash(size_t newCapacity);
+    void migrateStep();
+    void finishRehash();
 
 public:
-    explicit HashMap(size_t initialCapacity = DEFAULT_CAPACITY);
+    explicit HashMap(size_t initialCapacity = DEFAULT_CAPACITY,
+                     double maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR,
+                     RehashMode rehashMode = FULL_REHASH);
     
     HashMap(const HashMap&) = delete;
     HashMap& operator=(const HashMap&) = delete;
     
     HashMap(HashMap&& other) noexcept 
-        : table(std::move(other.table)), capacity(other.capacity), count(other.count) {
+        : table(std::move(other.table)), capacity(other.capacity), count(other.count),
+          maxLoad(other.maxLoad), mode(other.mode), hasher(std::move(other.hasher)),
+          keyEqual(std::move(other.keyEqual)), oldTable(std::move(other.oldTable)),
+          migrateFrom(other.migrateFrom), migrated(other.migrated) {
         other.capacity = 0;
         other.count = 0;
+        other.migrated = 0;
     }
     
     HashMap& operator=(HashMap&& other) noexcept {
@@ -46,8 +126,16 @@ public:
             table = std::move(other.table);
             capacity = other.capacity;
             count = other.count;
+            maxLoad = other.maxLoad;
+            mode = other.mode;
+            hasher = std::move(other.hasher);
+            keyEqual = std::move(other.keyEqual);
+            oldTable = std::move(other.oldTable);
+            migrateFrom = other.migrateFrom;
+            migrated = other.migrated;
             other.capacity = 0;
             other.count = 0;
+            other.migrated = 0;
         }
         return *this;
     }
@@ -61,33 +149,446 @@ public:
     bool empty() const;
     void print(std::ostream& os = std::cout) const;
     
+    // Поиск без копирования значения: указатель на значение или nullptr.
+    // Указатель действителен до следующего изменения таблицы
+    const V* find(const K& key) const;
+    V* find(const K& key);
+    
+    // Разнородный поиск (только при прозрачных Hash и KeyEqual)
+    template<typename Q, typename = EnableLookup<Q>>
+    const V* find(const Q& key) const;
+    template<typename Q, typename = EnableLookup<Q>>
+    V* find(const Q& key);
+    template<typename Q, typename = EnableLookup<Q>>
+    bool contains(const Q& key) const;
+    
+    // Пакетные операции: хеши порции ключей вычисляются заранее, их слоты
+    // предвыбираются, затем ключи разрешаются по очереди.
+    // results[i] - указатель на значение keys[i] или nullptr
+    template<typename Q>
+    std::vector<const V*> getMany(const std::vector<Q>& keys) const;
+    void putMany(const std::vector<std::pair<K, V>>& items);
+    
+    // Управление ёмкостью: таблица растёт сама, когда size() / bucketCount()
+    // превышает maxLoadFactor(), поэтому put() работает за амортизированное O(1)
+    size_t bucketCount() const;
+    double loadFactor() const;
+    double maxLoadFactor() const;
+    void setMaxLoadFactor(double factor);
+    void reserve(size_t n);
+    void shrink_to_fit();
+    RehashMode rehashMode() const;
+    void setRehashMode(RehashMode newMode);
+    bool isRehashing() const;
+    // Наибольшее расстояние от домашнего слота среди всех элементов (O(n))
+    size_t maxProbeDistance() const;
+    
     // Бинарная сериализация
     void saveToBinary(std::ofstream& out) const;
     void loadFromBinary(std::ifstream& in);
 };
 
-template<typename K, typename V>
+// Потокобезопасная хеш-таблица с разбиением на сегменты (lock striping):
+// ключ по хешу попадает в один из N независимых HashMap со своим
+// std::shared_mutex. Чтения одного сегмента идут параллельно,
+// записи в разные сегменты не мешают друг другу
+template<typename K, typename V,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = std::equal_to<>>
+class ConcurrentHashMap {
+private:
+    static const size_t DEFAULT_SHARDS = 64;
+    static const size_t DEFAULT_CAPACITY = 101;
+    // Каждый сегмент на своих строках кэша: блокировки соседних
+    // сегментов не делят одну строку (false sharing)
+    struct alignas(64) Shard {
+        mutable std::shared_mutex lock;
+        HashMap<K, V, Hash, KeyEqual> map;
+    };
+    std::unique_ptr<Shard[]> shards;
+    size_t shardMask;   // число сегментов - 1 (степень двойки)
+    Hash hasher;
+    
+    Shard& shardFor(const K& key) const;
+
+public:
+    explicit ConcurrentHashMap(size_t shardCount = DEFAULT_SHARDS,
+                               size_t initialCapacity = DEFAULT_CAPACITY);
+    
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+    
+    void put(const K& key, const V& value);
+    // Значение копируется под блокировкой: ссылки внутрь сегмента
+    // наружу не выдаются
+    V get(const K& key) const;
+    bool tryGet(const K& key, V& value) const;
+    bool contains(const K& key) const;
+    bool remove(const K& key);
+    void clear();
+    // Сумма по сегментам; при параллельных изменениях - мгновенный снимок
+    // не гарантируется
+    size_t size() const;
+    bool empty() const;
+    size_t shardCount() const;
+    void reserve(size_t n);
+};
+
+// Эпохи для отложенного освобождения памяти, которую могут читать потоки
+// без блокировок. Читатель на время операции публикует эпоху, в которой
+// начал (обычная запись + барьер, без атомарных read-modify-write);
+// писатель освобождает объект, только когда все активные читатели
+// вошли после его удаления из структуры
+class EpochDomain {
+public:
+    static constexpr size_t MAX_READERS = 256;
+    static constexpr uint64_t IDLE = 0;
+    
+    static EpochDomain& instance();
+    
+    void enter();
+    void leave();
+    uint64_t currentEpoch() const;
+    void advance();
+    // Наименьшая эпоха активных читателей или UINT64_MAX, если их нет
+    uint64_t minActiveEpoch() const;
+
+private:
+    struct alignas(64) ReaderRecord {
+        std::atomic<uint64_t> epoch{IDLE};
+        std::atomic<bool> used{false};
+    };
+    // Запись закрепляется за потоком при первом чтении и освобождается
+    // при его завершении; depth разрешает вложенные enter()
+    struct ReaderHandle {
+        EpochDomain& domain;
+        size_t index;
+        size_t depth;
+        explicit ReaderHandle(EpochDomain& owner);
+        ~ReaderHandle();
+    };
+    
+    alignas(64) std::atomic<uint64_t> globalEpoch{1};
+    ReaderRecord readers[MAX_READERS];
+    
+    EpochDomain() = default;
+    ReaderHandle& localHandle();
+};
+
+// Защищённая эпохой секция чтения
+class EpochGuard {
+public:
+    EpochGuard() { EpochDomain::instance().enter(); }
+    ~EpochGuard() { EpochDomain::instance().leave(); }
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+// Хеш-таблица для сценария «много чтений, редкие записи». Читатели не берут
+// блокировок: загружают текущую таблицу и цепочку корзины через acquire.
+// Писатели (по одному, под мьютексом) копируют изменяемую цепочку
+// и публикуют новую версию одной записью; старые узлы и таблицы
+// освобождаются через EpochDomain
+template<typename K, typename V,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = std::equal_to<>>
+class ReadMostlyHashMap {
+private:
+    static const size_t DEFAULT_CAPACITY = 64;
+    
+    // Узел неизменяем после публикации
+    struct Node {
+        K key;
+        V value;
+        size_t hash;
+        Node* next;
+    };
+    struct Table {
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+        size_t mask;
+        explicit Table(size_t capacity);
+    };
+    struct Retired {
+        Table* table;       // таблица целиком (вместе с узлами) или nullptr
+        Node* chain;        // отдельная цепочка
+        uint64_t epoch;
+    };
+    
+    std::atomic<Table*> current;
+    std::atomic<size_t> count;
+    std::mutex writeLock;
+    std::vector<Retired> retired;
+    Hash hasher;
+    KeyEqual keyEqual;
+    
+    size_t bucketOf(const Table* t, size_t hash) const;
+    const Node* findNode(const Table* t, const K& key, size_t hash) const;
+    // Копия цепочки без ключа skip (если он в ней есть)
+    Node* copyChainWithout(const Node* head, const K& skip, size_t hash);
+    static void freeChain(Node* head);
+    static void freeTable(Table* t);
+    void retire(Table* t, Node* chain);
+    void reclaim();
+    void grow();
+
+public:
+    explicit ReadMostlyHashMap(size_t initialCapacity = DEFAULT_CAPACITY);
+    ~ReadMostlyHashMap();
+    ReadMostlyHashMap(const ReadMostlyHashMap&) = delete;
+    ReadMostlyHashMap& operator=(const ReadMostlyHashMap&) = delete;
+    
+    // Чтения: без блокировок, значение копируется внутри секции эпохи
+    V get(const K& key) const;
+    bool tryGet(const K& key, V& value) const;
+    bool contains(const K& key) const;
+    
+    // Записи сериализуются мьютексом
+    void put(const K& key, const V& value);
+    bool remove(const K& key);
+    void clear();
+    
+    size_t size() const;
+    bool empty() const;
+    size_t bucketCount() const;
+    // Ожидающие освобождения версии (для тестов и диагностики)
+    size_t pendingReclamation();
+};
+
+// Группа из 16 управляющих байтов SwissHashMap. Полный слот хранит 7 младших
+// бит хеша (H2), пустой и удалённый - отрицательные маркеры. Вся группа
+// сравнивается одной SSE2-инструкцией; результат - битовая маска слотов
+struct ControlGroup {
+    static constexpr int8_t EMPTY = -128;
+    static constexpr int8_t DELETED = -2;
+    static constexpr size_t WIDTH = 16;
+    
+    static uint32_t match(const int8_t* group, int8_t h2);
+    static uint32_t matchEmpty(const int8_t* group);
+    static uint32_t matchEmptyOrDeleted(const int8_t* group);
+    // Индекс младшего установленного бита маски
+    static size_t lowestBit(uint32_t mask);
+};
+
+// Ядро таблиц в стиле SwissTable: метаданные (по байту на слот) лежат
+// отдельно от слотов, поиск проверяет 16 слотов за раз и обращается к
+// ключу только при совпадении 7-битного отпечатка хеша. Слот - любой тип,
+// KeyOf достаёт из него ключ; на ядре построены SwissHashMap и Set.
+// Заполненность до 7/8 слотов, удаление - надгробиями
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+class ControlTable {
+private:
+    std::vector<int8_t> ctrl;
+    std::vector<Slot> slots;
+    size_t groupMask;   // число групп - 1 (число групп - степень двойки)
+    size_t count;
+    size_t tombstones;
+    Hash hasher;
+    KeyEqual keyEqual;
+    KeyOf keyOf;
+    
+    template<typename Q>
+    size_t hashOf(const Q& key) const;
+    template<typename Q>
+    bool findSlot(const Q& key, size_t hash, size_t& index) const;
+    size_t findInsertSlot(size_t hash) const;
+    size_t growthLimit() const;
+    void resize(size_t groups);
+    static size_t groupsFor(size_t n);
+
+public:
+    explicit ControlTable(size_t initialCapacity = 0);
+    
+    // Слот с ключом или nullptr
+    template<typename Q>
+    const Slot* find(const Q& key) const;
+    template<typename Q>
+    Slot* find(const Q& key);
+    // Слот с ключом; если ключа нет - новый занятый слот, который
+    // заполняет вызывающий (second == true)
+    template<typename Q>
+    std::pair<Slot*, bool> insert(const Q& key);
+    template<typename Q>
+    bool erase(const Q& key);
+    void clear();
+    size_t size() const;
+    size_t bucketCount() const;
+    void reserve(size_t n);
+    // Байты под слоты и метаданные
+    size_t memoryUsage() const;
+    
+    // Доступ по номеру слота - для обхода и деления диапазонов между потоками
+    bool occupied(size_t index) const;
+    const Slot& slotAt(size_t index) const;
+    size_t groupCount() const;
+};
+
+// Хеш-таблица в стиле SwissTable на ядре ControlTable. Hash и KeyEqual -
+// как у HashMap; при прозрачных (по умолчанию для строк) contains
+// принимает любой совместимый ключ, например std::string_view
+template<typename K, typename V,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = std::equal_to<>>
+class SwissHashMap {
+private:
+    static const size_t DEFAULT_CAPACITY = 128;
+    struct Slot {
+        K key;
+        V value;
+    };
+    struct KeyOfSlot {
+        const K& operator()(const Slot& slot) const { return slot.key; }
+    };
+    ControlTable<Slot, KeyOfSlot, Hash, KeyEqual> table;
+    
+    template<typename Q>
+    using EnableLookup = std::enable_if_t<IsTransparentLookup<Hash, KeyEqual, Q>::value>;
+
+public:
+    explicit SwissHashMap(size_t initialCapacity = DEFAULT_CAPACITY);
+    
+    SwissHashMap(const SwissHashMap&) = delete;
+    SwissHashMap& operator=(const SwissHashMap&) = delete;
+    SwissHashMap(SwissHashMap&&) noexcept = default;
+    SwissHashMap& operator=(SwissHashMap&&) noexcept = default;
+    
+    void put(const K& key, const V& value);
+    V get(const K& key) const;
+    bool contains(const K& key) const;
+    template<typename Q, typename = EnableLookup<Q>>
+    bool contains(const Q& key) const;
+    bool remove(const K& key);
+    void clear();
+    size_t size() const;
+    bool empty() const;
+    size_t bucketCount() const;
+    void reserve(size_t n);
+    void print(std::ostream& os = std::cout) const;
+};
+
+// Компактная строковая хеш-таблица (структура массивов): слоты содержат
+// только метаданные (хеш, смещение записи, расстояние пробы) - 16 байт
+// вместо ~72 у HashMap<std::string, std::string>::Entry. Ключи и значения
+// лежат подряд в общей арене: [длина ключа][длина значения][ключ][значение].
+// Рост таблицы не трогает арену, обход и сохранение читают её последовательно
+class CompactStringMap {
+private:
+    static const size_t DEFAULT_CAPACITY = 128;
+    static constexpr uint32_t EMPTY = 0xFFFFFFFF;   // dist свободного слота
+    static constexpr uint32_t DEAD = 0x80000000;    // бит в длине ключа удалённой записи
+    static constexpr double MAX_LOAD_FACTOR = 0.8;
+    
+    struct Slot {
+        uint64_t hash;
+        uint32_t offset;    // начало записи в арене
+        uint32_t dist;      // расстояние от домашнего слота или EMPTY
+    };
+    std::vector<Slot> slots;
+    std::vector<char> arena;
+    size_t mask;            // ёмкость - 1 (ёмкость - степень двойки)
+    size_t count;
+    size_t garbage;         // байты удалённых и перезаписанных записей
+    
+    static constexpr size_t HEADER_SIZE = 2 * sizeof(uint32_t);
+    static uint64_t hashOf(std::string_view key);
+    uint32_t keyLength(uint32_t offset) const;
+    uint32_t valueLength(uint32_t offset) const;
+    std::string_view keyAt(uint32_t offset) const;
+    std::string_view valueAt(uint32_t offset) const;
+    size_t recordSize(uint32_t offset) const;
+    uint32_t appendRecord(std::string_view key, std::string_view value);
+    void killRecord(uint32_t offset);
+    bool pointsIntoArena(std::string_view text) const;
+    bool findSlot(std::string_view key, uint64_t hash, size_t& index) const;
+    void insertSlot(Slot slot);
+    void resize(size_t newCapacity);
+    // Перепаковка арены в порядке слотов, когда мусора больше живых данных
+    void compact();
+
+public:
+    explicit CompactStringMap(size_t initialCapacity = DEFAULT_CAPACITY);
+    
+    void put(std::string_view key, std::string_view value);
+    std::string get(std::string_view key) const;
+    // Значение без копирования; действительно до следующего изменения
+    bool find(std::string_view key, std::string_view& value) const;
+    bool contains(std::string_view key) const;
+    bool remove(std::string_view key);
+    void clear();
+    size_t size() const;
+    bool empty() const;
+    size_t bucketCount() const;
+    void reserve(size_t n);
+    // Байты, занятые слотами и ареной (включая мусор)
+    size_t memoryUsage() const;
+    size_t arenaBytes() const;
+    
+    // Обход живых записей в порядке арены: f(ключ, значение)
+    template<typename F>
+    void forEach(F f) const;
+    void print(std::ostream& os = std::cout) const;
+    
+    // Формат совпадает с HashMap<std::string, std::string>
+    void saveToBinary(std::ofstream& out) const;
+    void loadFromBinary(std::ifstream& in);
+};
+
+// Кукушкино хеширование: у ключа по одному слоту в каждой из двух таблиц,
+// поиск проверяет их и небольшой стэш - O(1) в худшем случае. Вставка
+// вытесняет жильцов итеративно; цепочка длиннее MAX_KICKS считается циклом,
+// и бездомный элемент уходит в стэш. При полном стэше таблицы
+// перестраиваются с новым seed'ом, а если это не помогает - с удвоением.
+// Позиции в таблицах - две половины 128-битного хеша с seed'ом
+// (SeededHash); обычный хеш вида hasher(key) -> size_t тоже допустим,
+// тогда seed применяется к его значению
+template<typename K, typename V,
+         typename Hash = SeededHash<K>,
+         typename KeyEqual = std::equal_to<>>
 class CuckooHashMap {
 private:
     static const size_t DEFAULT_CAPACITY = 101;
-    static const int MAX_ITERATIONS = 500;
+    static const int MAX_KICKS = 100;
+    static const size_t STASH_SIZE = 4;
+    // Перестроений с новыми seed'ами до удвоения ёмкости
+    static const int RESEEDS_PER_SIZE = 3;
+    static const int MAX_REBUILD_ATTEMPTS = 9;
+    // Доля занятых слотов обеих таблиц; выше ~0.5 циклы становятся частыми
+    static constexpr double MAX_LOAD_FACTOR = 0.45;
     
+    // Хеш текущего seed'а хранится в записи: вытеснение и рост без смены
+    // seed'а не вызывают хеш-функцию ключа
     struct Entry {
         K key;
         V value;
+        Hash128 hash;
         bool occupied;
         Entry();
-        Entry(const K& k, const V& v);
+        Entry(const K& k, const V& v, Hash128 h);
     };
     
     std::vector<Entry> table1;
     std::vector<Entry> table2;
+    std::vector<Entry> stash;
     size_t capacity;
     size_t count;
+    uint64_t generation;    // номер seed'а
+    uint64_t seed;
+    Hash hasher;
+    KeyEqual keyEqual;
     
-    size_t hash1(const K& key) const;
-    size_t hash2(const K& key) const;
-    bool insertInternal(const K& key, const V& value, int iterations);
+    void setSeed(uint64_t newGeneration);
+    Hash128 hashOf(const K& key) const;
+    size_t index1(const Hash128& hash) const;
+    size_t index2(const Hash128& hash) const;
+    const Entry* findEntry(const K& key, const Hash128& hash) const;
+    // Размещение отсутствующего ключа. false - стэш полон,
+    // в entry остаётся вытесненный бездомный элемент
+    bool insertEntry(Entry& entry);
+    // Попытка разместить все элементы (и extra) в таблицах новой ёмкости
+    // с seed'ом поколения newGeneration; при неудаче состояние не меняется
+    bool tryRebuild(size_t newCapacity, uint64_t newGeneration, const Entry* extra);
+    void rebuild(size_t newCapacity, const Entry* extra);
+    // После удаления элементы стэша могут вернуться в освободившиеся слоты
+    void drainStash();
 
 public:
     explicit CuckooHashMap(size_t initialCapacity = DEFAULT_CAPACITY);
@@ -98,414 +599,437 @@ public:
     void clear();
     size_t size() const;
     bool empty() const;
+    // Слотов в обеих таблицах
+    size_t bucketCount() const;
+    double loadFactor() const;
+    size_t stashSize() const;
+    // Ёмкость под n элементов без перестроений при вставке
+    void reserve(size_t n);
     void print(std::ostream& os = std::cout) const;
+    
+    // Бинарная сериализация (формат как у HashMap)
+    void saveToBinary(std::ofstream& out) const;
+    void loadFromBinary(std::ifstream& in);
 };
 
-template<typename T>
-class Set {
+// Блочная кукушкина хеш-таблица: корзина из SlotsPerBucket слотов занимает
+// выровненный блок, в начале которого - однобайтовые отпечатки ключей.
+// У ключа две корзины; вторая вычисляется из первой и отпечатка
+// (partial-key cuckoo), поэтому при вытеснении ключ не хешируется заново.
+// Поиск читает не более двух корзин и сравнивает ключи только при
+// совпадении отпечатка; вставка ищет кратчайший путь вытеснений в ширину,
+// что позволяет заполнять таблицу на 90%+
+template<typename K, typename V,
+         size_t SlotsPerBucket = 4,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = std::equal_to<>>
+class BucketCuckooHashMap {
 private:
-    HashMap<T, bool> map;
+    static const size_t DEFAULT_CAPACITY = 64;
+    static const size_t MAX_BFS_DEPTH = 5;
+    static constexpr double MAX_LOAD_FACTOR = 0.95;
+    static constexpr double MIN_LOAD_FACTOR = 0.25;
+    static constexpr uint8_t EMPTY_TAG = 0;
     
+    struct alignas(64) Bucket {
+        uint8_t tags[SlotsPerBucket];
+        K keys[SlotsPerBucket];
+        V values[SlotsPerBucket];
+        Bucket();
+    };
+    // Узел поиска в ширину: корзина и слот родителя, из которого сюда
+    // переедет элемент
+    struct PathNode {
+        size_t bucket;
+        size_t parent;
+        size_t parentSlot;
+        size_t depth;
+    };
+    
+    std::vector<Bucket> buckets;
+    size_t mask;    // число корзин - 1 (степень двойки)
+    size_t count;
+    Hash hasher;
+    KeyEqual keyEqual;
+    
+    size_t hashOf(const K& key) const;
+    static uint8_t tagOf(size_t hash);
+    size_t primaryIndex(size_t hash) const;
+    size_t altIndex(size_t index, uint8_t tag) const;
+    bool findSlot(const K& key, size_t hash, size_t& bucket, size_t& slot) const;
+    static int freeSlot(const Bucket& bucket);
+    // Освобождает слот в одной из корзин i1/i2 сдвигом по найденному пути
+    bool makeRoom(size_t i1, size_t i2, size_t& bucket, size_t& slot);
+    void place(size_t bucket, size_t slot, uint8_t tag, const K& key, const V& value);
+    bool tryRehash(size_t total);
+    void grow();
+    void degenerateCheck(size_t total) const;
+
 public:
-    explicit Set(size_t initialCapacity = 101);
-    void add(const T& value);
-    bool contains(const T& value) const;
-    bool remove(const T& value);
+    explicit BucketCuckooHashMap(size_t initialCapacity = DEFAULT_CAPACITY);
+    void put(const K& key, const V& value);
+    V get(const K& key) const;
+    bool contains(const K& key) const;
+    bool remove(const K& key);
     void clear();
     size_t size() const;
     bool empty() const;
+    // Общее число слотов
+    size_t bucketCount() const;
+    double loadFactor() const;
     void print(std::ostream& os = std::cout) const;
 };
 
-template<typename K, typename V>
-HashMap<K, V>::Entry::Entry() : occupied(false) {}
-
-template<typename K, typename V>
-HashMap<K, V>::Entry::Entry(const K& k, const V& v) : key(k), value(v), occupied(true) {}
-
-template<typename K, typename V>
-HashMap<K, V>::HashMap(size_t initialCapacity) 
-    : capacity(initialCapacity), count(0) {
-    table.resize(capacity);
-}
-
-template<typename K, typename V>
-size_t HashMap<K, V>::hash1(const K& key) const {
-    std::hash<K> hasher;
-    return hasher(key) % capacity;
-}
-
-template<typename K, typename V>
-size_t HashMap<K, V>::hash2(const K& key) const {
-    std::hash<K> hasher;
-    size_t h = hasher(key) % (capacity - 1);
-    return h == 0 ? 1 : h;
-}
-
-template<typename K, typename V>
-bool HashMap<K, V>::findIndex(const K& key, size_t& index) const {
-    size_t h1 = hash1(key);
-    size_t h2 = hash2(key);
-    index = h1;
-    
-    for (size_t i = 0; i < capacity; i++) {
-        if (!table[index].occupied) {
-            return false;
-        }
-        if (table[index].key == key) {
-            return true;
-        }
-        index = (h1 + (i + 1) * h2) % capacity;
-    }
-    throw std::runtime_error("Хеш-таблица заполнена");
-}
-
-template<typename K, typename V>
-void HashMap<K, V>::put(const K& key, const V& value) {
-    if (count >= capacity) {
-        throw std::runtime_error("Хеш-таблица заполнена");
-    }
-    size_t index;
-    bool found = findIndex(key, index);
-    if (found) {
-        table[index].value = value;
-    } else {
-        table[index] = Entry(key, value);
-        count++;
-    }
-}
-
-template<typename K, typename V>
-V HashMap<K, V>::get(const K& key) const {
-    size_t index;
-    if (findIndex(key, index)) {
-        return table[index].value;
-    }
-    throw std::runtime_error("Ключ не найден");
-}
-
-template<typename K, typename V>
-bool HashMap<K, V>::contains(const K& key) const {
-    size_t index;
-    return findIndex(key, index);
-}
-
-template<typename K, typename V>
-bool HashMap<K, V>::remove(const K& key) {
-    size_t index;
-    if (findIndex(key, index)) {
-        table[index].occupied = false;
-        count--;
-        return true;
-    }
-    return false;
-}
-
-template<typename K, typename V>
-void HashMap<K, V>::clear() {
-    for (auto& entry : table) {
-        entry.occupied = false;
-    }
-    count = 0;
-}
-
-template<typename K, typename V>
-size_t HashMap<K, V>::size() const {
-    return count;
-}
-
-template<typename K, typename V>
-bool HashMap<K, V>::empty() const {
-    return count == 0;
-}
-
-template<typename K, typename V>
-void HashMap<K, V>::print(std::ostream& os) const {
-    os << "HashMap {\n";
-    for (size_t i = 0; i < capacity; i++) {
-        if (table[i].occupied) {
-            os << "  [" << i << "] " << table[i].key 
-               << " => " << table[i].value << "\n";
-        }
-    }
-    os << "} (size: " << count << ")";
-}
-
-template<typename K, typename V>
-void HashMap<K, V>::saveToBinary(std::ofstream& out) const {
-    uint32_t sz = static_cast<uint32_t>(count);
-    out.write(reinterpret_cast<const char*>(&sz), sizeof(sz));
-    
-    for (size_t i = 0; i < capacity; i++) {
-        if (table[i].occupied) {
-            out.write(reinterpret_cast<const char*>(&table[i].key), sizeof(K));
-            out.write(reinterpret_cast<const char*>(&table[i].value), sizeof(V));
-        }
-    }
-}
-
-template<typename K, typename V>
-void HashMap<K, V>::loadFromBinary(std::ifstream& in) {
-    clear();
-    uint32_t sz;
-    in.read(reinterpret_cast<char*>(&sz), sizeof(sz));
+// Потокобезопасная блочная кукушкина таблица в духе MemC3/libcuckoo.
+// Корзины устроены как в BucketCuckooHashMap. Корзины разбиты на полосы
+// (stripes); счётчик версий полосы служит и спин-блокировкой (нечётный -
+// захвачен). Читатель не пишет в общую память: запоминает версии полос
+// двух корзин, читает слоты и повторяет чтение, если версии изменились.
+// Писатель блокирует полосы двух корзин в порядке возрастания номеров;
+// путь вытеснений ищется в ширину без блокировок, а каждый шаг
+// перемещения проверяется и выполняется под блокировкой пары корзин.
+// Рост захватывает все полосы; старая таблица освобождается через
+// EpochDomain. Чтение без блокировок допустимо только для ключей
+// и значений, которые атомарны без блокировок (целые, указатели)
+template<typename K, typename V,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = std::equal_to<>>
+class ConcurrentCuckooHashMap {
+    static_assert(std::atomic<K>::is_always_lock_free && std::atomic<V>::is_always_lock_free,
+                  "ConcurrentCuckooHashMap: ключ и значение должны быть атомарными без блокировок");
+private:
+    static const size_t SLOTS_PER_BUCKET = 4;
+    static const size_t STRIPES = 1024;
+    static const size_t DEFAULT_CAPACITY = 64;
+    static const size_t MAX_BFS_DEPTH = 5;
+    static constexpr uint8_t EMPTY_TAG = 0;
     
-    for (uint32_t i = 0; i < sz; i++) {
-        K key;
-        V value;
-        in.read(reinterpret_cast<char*>(&key), sizeof(K));
-        in.read(reinterpret_cast<char*>(&value), sizeof(V));
-        put(key, value);
-    }
-}
-
-// Специализация для std::string
-template<>
-inline void HashMap<std::string, std::string>::saveToBinary(std::ofstream& out) const {
-    uint32_t sz = static_cast<uint32_t>(count);
-    out.write(reinterpret_cast<const char*>(&sz), sizeof(sz));
-    
-    for (size_t i = 0; i < capacity; i++) {
-        if (table[i].occupied) {
-            uint32_t keyLen = static_cast<uint32_t>(table[i].key.length());
-            out.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
-            out.write(table[i].key.c_str(), keyLen);
-            
-            uint32_t valLen = static_cast<uint32_t>(table[i].value.length());
-            out.write(reinterpret_cast<const char*>(&valLen), sizeof(valLen));
-            out.write(table[i].value.c_str(), valLen);
-        }
-    }
-}
-
-template<>
-inline void HashMap<std::string, std::string>::loadFromBinary(std::ifstream& in) {
-    clear();
-    uint32_t sz;
-    in.read(reinterpret_cast<char*>(&sz), sizeof(sz));
-    
-    for (uint32_t i = 0; i < sz; i++) {
-        uint32_t keyLen;
-        in.read(reinterpret_cast<char*>(&keyLen), sizeof(keyLen));
-        std::string key(keyLen, '\0');
-        in.read(&key[0], keyLen);
-        
-        uint32_t valLen;
-        in.read(reinterpret_cast<char*>(&valLen), sizeof(valLen));
-        std::string value(valLen, '\0');
-        in.read(&value[0], valLen);
-        
-        put(key, value);
-    }
-}
-
-// Реализация CuckooHashMap
-template<typename K, typename V>
-CuckooHashMap<K, V>::Entry::Entry() : occupied(false) {}
-
-template<typename K, typename V>
-CuckooHashMap<K, V>::Entry::Entry(const K& k, const V& v) : key(k), value(v), occupied(true) {}
-
-template<typename K, typename V>
-CuckooHashMap<K, V>::CuckooHashMap(size_t initialCapacity) 
-    : capacity(initialCapacity), count(0) {
-    table1.resize(capacity);
-    table2.resize(capacity);
-}
-
-template<typename K, typename V>
-size_t CuckooHashMap<K, V>::hash1(const K& key) const {
-    std::hash<K> hasher;
-    return hasher(key) % capacity;
-}
-
-template<typename K, typename V>
-size_t CuckooHashMap<K, V>::hash2(const K& key) const {
-    std::hash<K> hasher;
-    return (hasher(key) / capacity) % capacity;
-}
-
-template<typename K, typename V>
-bool CuckooHashMap<K, V>::insertInternal(const K& key, const V& value, int iterations) {
-    if (iterations >= MAX_ITERATIONS) {
-        throw std::runtime_error("CuckooHashMap: слишком много итераций, требуется рехеширование");
-    }
+    struct alignas(64) Bucket {
+        std::atomic<uint8_t> tags[SLOTS_PER_BUCKET];
+        std::atomic<K> keys[SLOTS_PER_BUCKET];
+        std::atomic<V> values[SLOTS_PER_BUCKET];
+        Bucket();
+    };
+    struct Table {
+        std::unique_ptr<Bucket[]> buckets;
+        size_t mask;
+        explicit Table(size_t bucketCount);
+    };
+    struct alignas(64) Stripe {
+        std::atomic<uint64_t> version{0};
+    };
+    // Шаг вытеснения: элемент с отпечатком tag из слота slot корзины from
+    // переезжает в свою вторую корзину to
+    struct Move {
+        size_t from;
+        size_t slot;
+        size_t to;
+        uint8_t tag;
+    };
+    struct Retired {
+        Table* table;
+        uint64_t epoch;
+    };
     
-    size_t idx1 = hash1(key);
+    std::atomic<Table*> current;
+    std::unique_ptr<Stripe[]> stripes;
+    std::atomic<size_t> count;
+    std::mutex resizeLock;      // рост, очистка и освобождение таблиц
+    std::vector<Retired> retired;
+    Hash hasher;
+    KeyEqual keyEqual;
     
-    if (!table1[idx1].occupied) {
-        table1[idx1] = Entry(key, value);
-        return true;
-    }
+    size_t hashOf(const K& key) const;
+    static uint8_t tagOf(size_t hash);
+    static size_t altIndex(const Table* t, size_t index, uint8_t tag);
+    static size_t stripeOf(size_t bucket);
     
-    if (table1[idx1].key == key) {
-        table1[idx1].value = value;
-        return true;
-    }
+    // Версия полосы без захвата; ждёт, пока писатель её отпустит
+    uint64_t stableVersion(size_t stripe) const;
+    void lockStripe(size_t stripe);
+    void unlockStripe(size_t stripe);
+    void lockPair(size_t b1, size_t b2);
+    void unlockPair(size_t b1, size_t b2);
     
-    K oldKey = table1[idx1].key;
-    V oldValue = table1[idx1].value;
-    table1[idx1] = Entry(key, value);
+    bool findOptimistic(const K& key, V* value) const;
+    static int findKey(const Bucket& bucket, uint8_t tag, const K& key, const KeyEqual& equal);
+    static int freeSlot(const Bucket& bucket);
+    // Кратчайший путь вытеснений, освобождающий слот в b1 или b2;
+    // шаги - в порядке выполнения (от свободной корзины к корню)
+    static bool findPath(const Table* t, size_t b1, size_t b2, std::vector<Move>& path);
+    // Выполняет шаг, если слот ещё содержит тот же элемент и в корзине
+    // назначения есть место
+    static bool applyMove(Table* t, const Move& move);
+    // Размещение в таблице, которую не видят другие потоки
+    static bool placePrivate(Table* t, size_t hash, const K& key, const V& value);
+    void grow(Table* expected);
+    void retire(Table* t);
+    void reclaim();
+
+public:
+    explicit ConcurrentCuckooHashMap(size_t initialCapacity = DEFAULT_CAPACITY);
+    ~ConcurrentCuckooHashMap();
+    ConcurrentCuckooHashMap(const ConcurrentCuckooHashMap&) = delete;
+    ConcurrentCuckooHashMap& operator=(const ConcurrentCuckooHashMap&) = delete;
     
-    size_t idx2 = hash2(oldKey);
+    // Чтения: без блокировок и без записи в общую память
+    V get(const K& key) const;
+    bool tryGet(const K& key, V& value) const;
+    bool contains(const K& key) const;
     
-    if (!table2[idx2].occupied) {
-        table2[idx2] = Entry(oldKey, oldValue);
-        return true;
-    }
+    void put(const K& key, const V& value);
+    bool remove(const K& key);
+    void clear();
+    size_t size() const;
+    bool empty() const;
+    // Общее число слотов
+    size_t bucketCount() const;
+};
+
+// Множество - таблица ControlTable, слот которой - сам элемент: байт
+// метаданных на слот плюс элемент, без значения, кэшированного хеша и
+// выравнивания пары
+template<typename T,
+         typename Hash = DefaultHash<T>,
+         typename KeyEqual = std::equal_to<>>
+class Set {
+private:
+    struct SlotIsKey {
+        const T& operator()(const T& slot) const { return slot; }
+    };
+    ControlTable<T, SlotIsKey, Hash, KeyEqual> table;
     
-    if (table2[idx2].key == oldKey) {
-        table2[idx2].value = oldValue;
-        return true;
-    }
+    template<typename Q>
+    using EnableLookup = std::enable_if_t<IsTransparentLookup<Hash, KeyEqual, Q>::value>;
     
-    K nextKey = table2[idx2].key;
-    V nextValue = table2[idx2].value;
-    table2[idx2] = Entry(oldKey, oldValue);
+    // Элементы, прошедшие фильтр; диапазоны слотов делятся между потоками
+    template<typename Pred>
+    std::vector<T> collect(Pred keep, size_t threads) const;
     
-    return insertInternal(nextKey, nextValue, iterations + 1);
-}
-
-template<typename K, typename V>
-void CuckooHashMap<K, V>::put(const K& key, const V& value) {
-    if (count >= capacity * 2) {
-        throw std::runtime_error("CuckooHashMap заполнена");
-    }
+public:
+    // С этого размера просматриваемого множества операции алгебры
+    // выполняются параллельно
+    static constexpr size_t PARALLEL_THRESHOLD = 1 << 15;
     
-    if (contains(key)) {
-        size_t idx1 = hash1(key);
-        size_t idx2 = hash2(key);
-        
-        if (table1[idx1].occupied && table1[idx1].key == key) {
-            table1[idx1].value = value;
-        } else if (table2[idx2].occupied && table2[idx2].key == key) {
-            table2[idx2].value = value;
-        }
-        return;
-    }
+    explicit Set(size_t initialCapacity = 0);
+    void add(const T& value);
+    bool contains(const T& value) const;
+    // Разнородная проверка, например по std::string_view для Set<std::string>
+    template<typename Q, typename = EnableLookup<Q>>
+    bool contains(const Q& value) const;
+    bool remove(const T& value);
+    void clear();
+    size_t size() const;
+    bool empty() const;
+    // Число слотов
+    size_t bucketCount() const;
+    void reserve(size_t n);
+    // Байты под слоты и метаданные
+    size_t memoryUsage() const;
     
-    if (insertInternal(key, value, 0)) {
-        count++;
-    }
-}
-
-template<typename K, typename V>
-V CuckooHashMap<K, V>::get(const K& key) const {
-    size_t idx1 = hash1(key);
-    size_t idx2 = hash2(key);
+    // Обход элементов в порядке слотов
+    template<typename F>
+    void forEach(F f) const;
+    void print(std::ostream& os = std::cout) const;
     
-    if (table1[idx1].occupied && table1[idx1].key == key) {
-        return table1[idx1].value;
-    }
-    if (table2[idx2].occupied && table2[idx2].key == key) {
-        return table2[idx2].value;
-    }
-    throw std::runtime_error("Ключ не найден");
-}
+    // Алгебра множеств. threads = 0 - число потоков по размеру входа
+    // и числу ядер; пересечение обходит меньшее множество и проверяет
+    // элементы в большем
+    static Set unionOf(const Set& a, const Set& b, size_t threads = 0);
+    static Set intersectionOf(const Set& a, const Set& b, size_t threads = 0);
+    static Set differenceOf(const Set& a, const Set& b, size_t threads = 0);
+};
 
-template<typename K, typename V>
-bool CuckooHashMap<K, V>::contains(const K& key) const {
-    size_t idx1 = hash1(key);
-    size_t idx2 = hash2(key);
+// Блочный фильтр Блума: все биты ключа лежат в одном 64-байтном блоке,
+// поэтому проверка стоит одного промаха кэша. Размер подбирается по
+// ожидаемому числу ключей и целевой доле ложных срабатываний; ложных
+// отрицаний нет, удаления нет
+template<typename T, typename Hash = DefaultHash<T>>
+class BloomFilter {
+private:
+    static constexpr size_t BLOCK_WORDS = 8;
+    static constexpr uint32_t BLOCK_BITS = BLOCK_WORDS * 64;
+    static constexpr uint32_t MAX_HASHES = 16;
+    static constexpr size_t PREFETCH_BATCH = 16;
+    // Блоков за одно чтение снимка (256 КБ)
+    static constexpr size_t LOAD_CHUNK = 4096;
+    struct alignas(64) Block {
+        uint64_t words[BLOCK_WORDS];
+    };
+    std::vector<Block> blocks;
+    uint32_t hashCount;
+    size_t count;
+    Hash hasher;
+    
+    template<typename Q>
+    using EnableLookup = std::enable_if_t<IsTransparentLookup<Hash, std::equal_to<>, Q>::value>;
+    
+    template<typename Q>
+    uint64_t hashOf(const Q& key) const;
+    size_t blockOf(uint64_t hash) const;
+    // Позиции битов внутри блока - из второго, независимого хеша
+    template<typename F>
+    void forEachBit(uint64_t hash, F f) const;
+    void addHashed(uint64_t hash);
+    bool testHashed(uint64_t hash) const;
+    // Доля ложных срабатываний при среднем числе ключей на блок: число
+    // ключей в блоке распределено по Пуассону, переполненные блоки
+    // ошибаются чаще, чем обычный фильтр того же размера
+    static double blockedFalsePositiveRate(double keysPerBlock, uint32_t hashes);
+    static uint32_t optimalHashes(double bitsPerKey);
+    
+public:
+    explicit BloomFilter(size_t expectedItems = 1000, double targetRate = 0.01);
+    void add(const T& key);
+    bool mightContain(const T& key) const;
+    // Разнородные добавление и проверка, например по std::string_view
+    // для строк: ключ не копируется в T
+    template<typename Q, typename = EnableLookup<Q>>
+    void add(const Q& key);
+    template<typename Q, typename = EnableLookup<Q>>
+    bool mightContain(const Q& key) const;
+    // Пакетная проверка: хеши и предвыборка блоков порции идут раньше
+    // чтений, промахи кэша перекрываются
+    template<typename Q>
+    std::vector<bool> mightContainMany(const std::vector<Q>& keys) const;
+    void clear();
+    // Число добавлений (повторы считаются)
+    size_t size() const;
+    bool empty() const;
+    size_t bitCount() const;
+    uint32_t hashFunctions() const;
+    // Ожидаемая доля ложных срабатываний при текущем заполнении
+    double falsePositiveRate() const;
+    size_t memoryUsage() const;
     
-    return (table1[idx1].occupied && table1[idx1].key == key) ||
-           (table2[idx2].occupied && table2[idx2].key == key);
-}
+    // Биты сохраняются как есть: снимок читается той же сборкой,
+    // с тем же хешем
+    void saveToBinary(std::ofstream& out) const;
+    void loadFromBinary(std::ifstream& in);
+};
 
-template<typename K, typename V>
-bool CuckooHashMap<K, V>::remove(const K& key) {
-    size_t idx1 = hash1(key);
-    size_t idx2 = hash2(key);
-    
-    if (table1[idx1].occupied && table1[idx1].key == key) {
-        table1[idx1].occupied = false;
-        count--;
-        return true;
-    }
-    if (table2[idx2].occupied && table2[idx2].key == key) {
-        table2[idx2].occupied = false;
-        count--;
-        return true;
-    }
-    return false;
-}
+// Пословные операции над битовыми картами: SSE2 обрабатывает по 128 бит
+// за инструкцию; возвращают мощность результата
+struct BitmapOps {
+    static uint32_t unite(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words);
+    static uint32_t intersect(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words);
+    // a без b
+    static uint32_t subtract(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words);
+    static uint32_t cardinality(const uint64_t* words, size_t count);
+};
 
-template<typename K, typename V>
-void CuckooHashMap<K, V>::clear() {
-    for (auto& entry : table1) {
-        entry.occupied = false;
-    }
-    for (auto& entry : table2) {
-        entry.occupied = false;
-    }
-    count = 0;
-}
+// Сжатое множество целых в стиле Roaring: значение делится на старшие
+// 16 бит (номер блока) и младшие 16 бит, которые блок хранит в одном
+// из трёх видов - отсортированный массив (до 4096 элементов), битовая
+// карта на 2^16 бит или список отрезков для плотных диапазонов
+template<typename T = uint32_t>
+class RoaringSet {
+    static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 4,
+                  "RoaringSet хранит целые не шире 32 бит");
+private:
+    using Unsigned = std::make_unsigned_t<T>;
+    // Инверсия знакового бита сохраняет порядок отрицательных значений
+    static constexpr Unsigned SIGN_FLIP =
+        std::is_signed<T>::value ? static_cast<Unsigned>(Unsigned(1) << (sizeof(T) * 8 - 1)) : 0;
+    static constexpr uint32_t ARRAY_MAX = 4096;
+    static constexpr size_t BITMAP_WORDS = 1024;
+    // Во сколько раз массив должен быть больше другого, чтобы вместо
+    // слияния искать элементы меньшего в нём двоичным поиском
+    static constexpr uint32_t GALLOP_RATIO = 32;
+    
+    enum Kind : uint8_t { ARRAY, BITMAP, RUNS };
+    enum Op { UNION, INTERSECTION, DIFFERENCE };
+    // Отрезок [start, start + length]
+    struct Run {
+        uint16_t start;
+        uint16_t length;
+    };
+    struct Container {
+        uint16_t key;
+        Kind kind;
+        uint32_t cardinality;
+        std::vector<uint16_t> array;
+        std::vector<uint64_t> bitmap;
+        std::vector<Run> runs;
+    };
+    std::vector<Container> containers;  // по возрастанию key
+    size_t count;
+    
+    static uint32_t toBits(T value);
+    static T fromBits(uint32_t bits);
+    
+    size_t lowerBound(uint16_t key) const;
+    const Container* findContainer(uint16_t key) const;
+    Container& containerFor(uint16_t key);
+    
+    static size_t findRun(const std::vector<Run>& runs, uint16_t low);
+    static bool containerContains(const Container& c, uint16_t low);
+    static bool containerAdd(Container& c, uint16_t low);
+    static bool containerRemove(Container& c, uint16_t low);
+    static void setRange(std::vector<uint64_t>& bitmap, uint32_t first, uint32_t last);
+    template<typename F>
+    static void forEachLow(const Container& c, F f);
+    
+    static void toArray(Container& c);
+    static void toBitmap(Container& c);
+    static std::vector<Run> runsOf(const Container& c);
+    static size_t containerBytes(const Container& c);
+    // Вид по мощности: массив или карта; отрезки остаются, пока они компактнее
+    static void normalize(Container& c);
+    // Замена на отрезки, только если они компактнее текущего вида
+    static void makeRuns(Container& c, std::vector<Run> runs);
+    
+    static const uint64_t* wordsOf(const Container& c, std::vector<uint64_t>& scratch);
+    static Container combine(const Container& a, const Container& b, Op op);
+    static Container combineRuns(const Container& a, const Container& b, Op op);
+    static RoaringSet combineSets(const RoaringSet& a, const RoaringSet& b, Op op);
+    
+public:
+    RoaringSet();
+    void add(T value);
+    // Все значения отрезка [first, last] сразу в виде отрезков
+    void addRange(T first, T last);
+    bool contains(T value) const;
+    bool remove(T value);
+    void clear();
+    size_t size() const;
+    bool empty() const;
+    // Перевод блоков в отрезки там, где так компактнее
+    void optimize();
+    // Байты под блоки и их данные
+    size_t memoryUsage() const;
+    
+    // Обход элементов по возрастанию
+    template<typename F>
+    void forEach(F f) const;
+    void print(std::ostream& os = std::cout) const;
+    
+    // Алгебра множеств поблочно; две битовые карты объединяются пословно
+    static RoaringSet unionOf(const RoaringSet& a, const RoaringSet& b);
+    static RoaringSet intersectionOf(const RoaringSet& a, const RoaringSet& b);
+    static RoaringSet differenceOf(const RoaringSet& a, const RoaringSet& b);
+};
 
+// Готовые комбинации стратегий: для целых ключей - перемешивающий хеш,
+// линейное пробирование и маска по степени двойки; для строк - Robin Hood
+// с кэшированным хешем и fastrange без деления
 template<typename K, typename V>
-size_t CuckooHashMap<K, V>::size() const {
-    return count;
-}
+using IntegerKeyHashMap = HashMap<K, V, IntegerHash, std::equal_to<K>, LinearProbing, PowerOfTwoReduction>;
 
-template<typename K, typename V>
-bool CuckooHashMap<K, V>::empty() const {
-    return count == 0;
-}
+template<typename V>
+using StringKeyHashMap = HashMap<std::string, V, StringHash, std::equal_to<>,
+                                 RobinHoodProbing, FastRangeReduction>;
 
-template<typename K, typename V>
-void CuckooHashMap<K, V>::print(std::ostream& os) const {
-    os << "CuckooHashMap {\n  Table 1:\n";
-    for (size_t i = 0; i < capacity; i++) {
-        if (table1[i].occupied) {
-            os << "    [" << i << "] " << table1[i].key << " => " << table1[i].value << "\n";
-        }
-    }
-    os << "  Table 2:\n";
-    for (size_t i = 0; i < capacity; i++) {
-        if (table2[i].occupied) {
-            os << "    [" << i << "] " << table2[i].key << " => " << table2[i].value << "\n";
-        }
-    }
-    os << "} (size: " << count << ")";
-}
-
-// Реализация Set
-
-template<typename T>
-Set<T>::Set(size_t initialCapacity) : map(initialCapacity) {}
-
-template<typename T>
-void Set<T>::add(const T& value) {
-    map.put(value, true);
-}
-
-template<typename T>
-bool Set<T>::contains(const T& value) const {
-    return map.contains(value);
-}
-
-template<typename T>
-bool Set<T>::remove(const T& value) {
-    return map.remove(value);
-}
-
-template<typename T>
-void Set<T>::clear() {
-    map.clear();
-}
-
-template<typename T>
-size_t Set<T>::size() const {
-    return map.size();
-}
-
-template<typename T>
-bool Set<T>::empty() const {
-    return map.empty();
-}
-
-template<typename T>
-void Set<T>::print(std::ostream& os) const {
-    os << "Set { size: " << size() << " }";
-}
+#include "hashmap.cpp"
+#include "swisstable.cpp"
+#include "compactmap.cpp"
+#include "concurrent.cpp"
+#include "readmostly.cpp"
+#include "cuckoo.cpp"
+#include "bucket_cuckoo.cpp"
+#include "concurrent_cuckoo.cpp"
+#include "set.cpp"
+#include "bloom.cpp"
+#include "roaring.cpp"
 
 #endif
@@ -0,0 +1,282 @@
+#ifndef HASH_POLICIES_H
+#define HASH_POLICIES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Стратегии для HashMap<K, V, Hash, KeyEqual, Probing, Reduction>.
+// Все функции статические и встраиваемые: каждая комбинация стратегий
+// компилируется в отдельный цикл поиска без косвенных вызовов
+
+// Хеш-функции
+
+// Финализатор MurmurHash3: каждый бит результата зависит от всех бит входа
+inline uint64_t mixHash64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Для целых ключей: std::hash<int> - тождество, что плохо для маскирования
+// младших бит и для fastrange (старшие биты малых чисел нулевые)
+struct IntegerHash {
+    template<typename T>
+    size_t operator()(T key) const {
+        return static_cast<size_t>(mixHash64(static_cast<uint64_t>(key)));
+    }
+};
+
+// Прозрачный хеш строк: std::hash<std::string_view> совпадает
+// с std::hash<std::string>, поэтому искать можно по string_view и строковым
+// литералам без построения std::string
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view key) const {
+        return std::hash<std::string_view>()(key);
+    }
+};
+
+// Хеш по умолчанию: std::hash<K>, для строк - прозрачный StringHash
+template<typename K>
+struct DefaultHash : std::hash<K> {};
+
+template<>
+struct DefaultHash<std::string> : StringHash {};
+
+// 128-битный хеш с seed'ом по схеме wyhash: две половины результата
+// независимы, из одного вызова получаются обе позиции кукушкиной таблицы
+struct Hash128 {
+    uint64_t first;
+    uint64_t second;
+    bool operator==(const Hash128& other) const {
+        return first == other.first && second == other.second;
+    }
+    bool operator!=(const Hash128& other) const {
+        return !(*this == other);
+    }
+};
+
+namespace wyhash_detail {
+
+const uint64_t SECRET0 = 0xa0761d6478bd642fULL;
+const uint64_t SECRET1 = 0xe7037ed1a0b428dbULL;
+const uint64_t SECRET2 = 0x8ebc6af09c88c6e3ULL;
+const uint64_t SECRET3 = 0x589965cc75374cc3ULL;
+
+// Полное 128-битное произведение: младшая половина в a, старшая в b
+inline void multiply(uint64_t& a, uint64_t& b) {
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 product = static_cast<uint128>(a) * b;
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+    multiply(a, b);
+    return a ^ b;
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 1-3 байта: первый, средний и последний
+inline uint64_t read3(const uint8_t* p, size_t len) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+}
+
+inline Hash128 wyHash128(const void* data, size_t len, uint64_t seed) {
+    using namespace wyhash_detail;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    seed ^= mix(seed ^ SECRET0, SECRET1);
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            // Три независимые полосы по 16 байт
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+                see1 = mix(read64(p + 16) ^ SECRET2, read64(p + 24) ^ see1);
+                see2 = mix(read64(p + 32) ^ SECRET3, read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mix(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    a ^= SECRET1;
+    b ^= seed;
+    multiply(a, b);
+    // Обе половины - разные финальные смешивания одного 128-битного состояния
+    return Hash128{mix(a ^ SECRET0 ^ len, b ^ SECRET1),
+                   mix(a ^ SECRET2, b ^ SECRET3 ^ len)};
+}
+
+// Семейство хешей с seed'ом: hasher(key, seed) -> Hash128. Для чисел
+// хешируется их представление в памяти, поэтому типы с битами-заполнителями
+// (и float, где 0.0 == -0.0) не допускаются
+template<typename K>
+struct SeededHash {
+    static_assert(std::has_unique_object_representations<K>::value,
+                  "SeededHash: тип ключа должен однозначно представляться байтами");
+    Hash128 operator()(const K& key, uint64_t seed) const {
+        return wyHash128(&key, sizeof(key), seed);
+    }
+};
+
+template<>
+struct SeededHash<std::string> {
+    using is_transparent = void;
+    Hash128 operator()(std::string_view key, uint64_t seed) const {
+        return wyHash128(key.data(), key.size(), seed);
+    }
+};
+
+// Хеш вида hasher(key, seed) -> Hash128
+template<typename Hash, typename K, typename = void>
+struct IsSeededHash : std::false_type {};
+
+template<typename Hash, typename K>
+struct IsSeededHash<Hash, K,
+                    std::void_t<decltype(std::declval<const Hash&>()(std::declval<const K&>(), uint64_t()))>>
+    : std::is_same<decltype(std::declval<const Hash&>()(std::declval<const K&>(), uint64_t())), Hash128> {};
+
+// Разнородный поиск по ключу типа Q разрешён, если и хеш, и сравнение
+// прозрачны (как в C++20 std::unordered_map)
+template<typename Hash, typename KeyEqual, typename Q, typename = void>
+struct IsTransparentLookup : std::false_type {};
+
+template<typename Hash, typename KeyEqual, typename Q>
+struct IsTransparentLookup<Hash, KeyEqual, Q,
+                           std::void_t<typename Hash::is_transparent,
+                                       typename KeyEqual::is_transparent>> : std::true_type {};
+
+// Схемы пробирования (обе линейные, удаление - сдвигом хвоста кластера)
+
+// Robin Hood: при вставке элемент, который ближе к своему слоту, уступает
+// место более далёкому; поиск останавливается, как только встречен
+// элемент ближе к дому, чем был бы искомый
+struct RobinHoodProbing {
+    static bool displaces(uint32_t residentDist, uint32_t incomingDist) {
+        return residentDist < incomingDist;
+    }
+    static bool stopsAt(uint32_t residentDist, uint32_t dist) {
+        return residentDist < dist;
+    }
+    // Элемент в своём домашнем слоте завершает сдвиг при удалении
+    static bool endsShift(uint32_t residentDist) {
+        return residentDist == 0;
+    }
+};
+
+// Обычное линейное пробирование: первый свободный слот, поиск до пустого слота
+struct LinearProbing {
+    static bool displaces(uint32_t, uint32_t) {
+        return false;
+    }
+    static bool stopsAt(uint32_t, uint32_t) {
+        return false;
+    }
+    static bool endsShift(uint32_t) {
+        return false;
+    }
+};
+
+// Отображение хеша в индекс слота
+
+// Остаток от деления на простую ёмкость: устойчив к слабым хешам,
+// но требует целочисленного деления на каждой пробе
+struct PrimeModuloReduction {
+    static size_t roundCapacity(size_t n) {
+        if (n <= 2) return 2;
+        if (n % 2 == 0) n++;
+        while (true) {
+            bool prime = true;
+            for (size_t d = 3; d * d <= n; d += 2) {
+                if (n % d == 0) {
+                    prime = false;
+                    break;
+                }
+            }
+            if (prime) return n;
+            n += 2;
+        }
+    }
+    static size_t reduce(size_t hash, size_t capacity) {
+        return hash % capacity;
+    }
+    static size_t next(size_t index, size_t capacity) {
+        return index + 1 == capacity ? 0 : index + 1;
+    }
+};
+
+// Ёмкость - степень двойки, индекс - младшие биты хеша
+struct PowerOfTwoReduction {
+    static size_t roundCapacity(size_t n) {
+        size_t capacity = 1;
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+    static size_t reduce(size_t hash, size_t capacity) {
+        return hash & (capacity - 1);
+    }
+    static size_t next(size_t index, size_t capacity) {
+        return (index + 1) & (capacity - 1);
+    }
+};
+
+// Fastrange (Lemire): (hash * capacity) >> 64 - любая ёмкость без деления,
+// индекс определяют старшие биты хеша
+struct FastRangeReduction {
+    static size_t roundCapacity(size_t n) {
+        return n;
+    }
+    static size_t reduce(size_t hash, size_t capacity) {
+        __extension__ typedef unsigned __int128 uint128;
+        return static_cast<size_t>((static_cast<uint128>(hash) * capacity) >> 64);
+    }
+    static size_t next(size_t index, size_t capacity) {
+        return index + 1 == capacity ? 0 : index + 1;
+    }
+};
+
+#endif
@@ -2,198 +2,485 @@
 #define HASHMAP_CPP
 
 #include <cstdint>
+#include <cmath>
+#include <algorithm>
 #include <fstream>
+#include <initializer_list>
 #include "../binary_serialization.h"
 #include "hash.h"
 
-template<typename K, typename V>
-HashMap<K, V>::Entry::Entry() : occupied(false) {}
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::Entry::Entry() : hash(0), dist(0), occupied(false) {}
 
-template<typename K, typename V>
-HashMap<K, V>::Entry::Entry(const K& k, const V& v) : key(k), value(v), occupied(true) {}
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::Entry::Entry(const K& k, const V& v, size_t h)
+    : key(k), value(v), hash(h), dist(0), occupied(true) {}
 
-template<typename K, typename V>
-HashMap<K, V>::HashMap(size_t initialCapacity) 
-    : capacity(initialCapacity), count(0) {
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::HashMap(size_t initialCapacity, double maxLoadFactor, RehashMode rehashMode) 
+    : capacity(Reduction::roundCapacity(std::max(initialCapacity, MIN_CAPACITY))), count(0),
+      maxLoad(DEFAULT_MAX_LOAD_FACTOR), mode(rehashMode), migrateFrom(0), migrated(0) {
+    setMaxLoadFactor(maxLoadFactor);
     table.resize(capacity);
 }
 
-template<typename K, typename V>
-size_t HashMap<K, V>::hash1(const K& key) const {
-    std::hash<K> hasher;
-    return hasher(key) % capacity;
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+size_t HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::capacityFor(size_t n) const {
+    size_t needed = static_cast<size_t>(std::ceil(static_cast<double>(n) / maxLoad));
+    if (needed <= n) needed = n + 1;
+    return Reduction::roundCapacity(std::max(needed, MIN_CAPACITY));
 }
 
-template<typename K, typename V>
-size_t HashMap<K, V>::hash2(const K& key) const {
-    std::hash<K> hasher;
-    size_t h = hasher(key) % (capacity - 1);
-    return h == 0 ? 1 : h;
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::grow() {
+    size_t newCapacity = std::max(Reduction::roundCapacity(capacity * 2), capacityFor(count + 1));
+    if (mode == FULL_REHASH) {
+        rehash(newCapacity);
+        return;
+    }
+    // Предыдущий перенос должен закончиться до начала следующего
+    finishRehash();
+    oldTable = std::vector<Entry>(newCapacity);
+    oldTable.swap(table);
+    capacity = newCapacity;
+    migrated = 0;
+    migrateFrom = 0;
+    while (oldTable[migrateFrom].occupied) {
+        migrateFrom++;
+    }
 }
 
-template<typename K, typename V>
-bool HashMap<K, V>::findIndex(const K& key, size_t& index) const {
-    size_t h1 = hash1(key);
-    size_t h2 = hash2(key);
-    index = h1;
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::rehash(size_t newCapacity) {
+    finishRehash();
+    std::vector<Entry> previous(newCapacity);
+    previous.swap(table);
+    capacity = newCapacity;
     
-    for (size_t i = 0; i < capacity; i++) {
-        if (!table[index].occupied) {
+    for (auto& entry : previous) {
+        if (entry.occupied) {
+            insertEntry(table, std::move(entry));
+        }
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::migrateStep() {
+    if (oldTable.empty()) return;
+    
+    size_t oldCapacity = oldTable.size();
+    size_t steps = 0;
+    while (migrated < oldCapacity) {
+        Entry& entry = oldTable[(migrateFrom + migrated) % oldCapacity];
+        // Останавливаемся только на пустом слоте: кластер переносится целиком
+        if (!entry.occupied && steps >= REHASH_STEP) break;
+        if (entry.occupied) {
+            entry.occupied = false;
+            insertEntry(table, std::move(entry));
+        }
+        migrated++;
+        steps++;
+    }
+    if (migrated == oldCapacity) {
+        std::vector<Entry>().swap(oldTable);
+        migrated = 0;
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::finishRehash() {
+    while (!oldTable.empty()) {
+        migrateStep();
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+template<typename Q>
+size_t HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::hashOf(const Q& key) const {
+    return hasher(key);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+template<typename Q>
+bool HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::findIndex(const std::vector<Entry>& t, const Q& key, size_t hash, size_t& index) const {
+    size_t cap = t.size();
+    index = Reduction::reduce(hash, cap);
+    
+    for (uint32_t dist = 0; dist < cap; dist++) {
+        // Для Robin Hood: элемент ближе к дому, чем искомый был бы здесь -
+        // по инварианту ключа дальше быть не может
+        if (!t[index].occupied || Probing::stopsAt(t[index].dist, dist)) {
             return false;
         }
-        if (table[index].key == key) {
+        if (t[index].hash == hash && keyEqual(t[index].key, key)) {
             return true;
         }
-        index = (h1 + (i + 1) * h2) % capacity;
+        index = Reduction::next(index, cap);
     }
     throw std::runtime_error("Хеш-таблица заполнена");
 }
 
-template<typename K, typename V>
-void HashMap<K, V>::put(const K& key, const V& value) {
-    if (count >= capacity) {
-        throw std::runtime_error("Хеш-таблица заполнена");
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+template<typename Q>
+bool HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::locate(const Q& key, size_t hash, bool& inOld, size_t& index) const {
+    inOld = false;
+    if (findIndex(table, key, hash, index)) {
+        return true;
+    }
+    if (!oldTable.empty() && findIndex(oldTable, key, hash, index)) {
+        inOld = true;
+        return true;
+    }
+    return false;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+uint32_t HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::insertEntry(std::vector<Entry>& t, Entry entry) {
+    size_t cap = t.size();
+    size_t index = Reduction::reduce(entry.hash, cap);
+    entry.occupied = true;
+    entry.dist = 0;
+    uint32_t longest = 0;
+    
+    while (t[index].occupied) {
+        if (Probing::displaces(t[index].dist, entry.dist)) {
+            std::swap(t[index], entry);
+        }
+        entry.dist++;
+        longest = std::max(longest, entry.dist);
+        index = Reduction::next(index, cap);
+    }
+    t[index] = std::move(entry);
+    return longest;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::eraseAt(std::vector<Entry>& t, size_t index) {
+    // Сдвиг назад: элемент кластера переезжает в дыру, если она не раньше
+    // его домашнего слота (dist >= расстояния до дыры). Для Robin Hood
+    // это всегда соседний элемент, и сдвиг заканчивается на элементе в своём слоте
+    size_t cap = t.size();
+    size_t hole = index;
+    uint32_t gap = 1;
+    size_t next = Reduction::next(index, cap);
+    while (t[next].occupied && !Probing::endsShift(t[next].dist)) {
+        if (t[next].dist >= gap) {
+            uint32_t newDist = t[next].dist - gap;
+            t[hole] = std::move(t[next]);
+            t[hole].dist = newDist;
+            hole = next;
+            gap = 0;
+        }
+        gap++;
+        next = Reduction::next(next, cap);
     }
+    t[hole].occupied = false;
+    t[hole].dist = 0;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::put(const K& key, const V& value) {
+    putHashed(key, value, hashOf(key));
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::putHashed(const K& key, const V& value, size_t hash) {
+    migrateStep();
+    
+    bool inOld;
     size_t index;
-    bool found = findIndex(key, index);
-    if (found) {
-        table[index].value = value;
-    } else {
-        table[index] = Entry(key, value);
-        count++;
+    if (locate(key, hash, inOld, index)) {
+        (inOld ? oldTable : table)[index].value = value;
+        return;
+    }
+    // Рост только при вставке нового ключа: обновление не меняет заполненность.
+    // Удвоение ёмкости даёт амортизированное O(1) на вставку
+    if (static_cast<double>(count + 1) > maxLoad * static_cast<double>(capacity)) {
+        grow();
+    }
+    uint32_t longest = insertEntry(table, Entry(key, value, hash));
+    count++;
+    // Слишком длинная цепочка при умеренной заполненности - признак
+    // скопления коллизий; рост разбивает кластер. При низкой заполненности
+    // рост не поможет (совпадающие хеши), поэтому не делаем его
+    if (longest > MAX_PROBE_DISTANCE && loadFactor() > maxLoad / 2) {
+        grow();
     }
 }
 
-template<typename K, typename V>
-V HashMap<K, V>::get(const K& key) const {
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+V HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::get(const K& key) const {
+    bool inOld;
     size_t index;
-    if (findIndex(key, index)) {
-        return table[index].value;
+    if (locate(key, hashOf(key), inOld, index)) {
+        return (inOld ? oldTable : table)[index].value;
     }
     throw std::runtime_error("Ключ не найден");
 }
 
-template<typename K, typename V>
-bool HashMap<K, V>::contains(const K& key) const {
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+bool HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::contains(const K& key) const {
+    bool inOld;
+    size_t index;
+    return locate(key, hashOf(key), inOld, index);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+template<typename Q>
+const V* HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::findValue(const Q& key) const {
+    bool inOld;
     size_t index;
-    return findIndex(key, index);
+    if (locate(key, hashOf(key), inOld, index)) {
+        return &(inOld ? oldTable : table)[index].value;
+    }
+    return nullptr;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+const V* HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::find(const K& key) const {
+    return findValue(key);
 }
 
-template<typename K, typename V>
-bool HashMap<K, V>::remove(const K& key) {
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+V* HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::find(const K& key) {
+    return const_cast<V*>(findValue(key));
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+template<typename Q, typename>
+const V* HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::find(const Q& key) const {
+    return findValue(key);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+template<typename Q, typename>
+V* HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::find(const Q& key) {
+    return const_cast<V*>(findValue(key));
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+template<typename Q, typename>
+bool HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::contains(const Q& key) const {
+    bool inOld;
     size_t index;
-    if (findIndex(key, index)) {
-        table[index].occupied = false;
+    return locate(key, hashOf(key), inOld, index);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::prefetchSlot(const std::vector<Entry>& t, size_t hash) const {
+    if (t.empty()) return;
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&t[Reduction::reduce(hash, t.size())]);
+#endif
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+template<typename Q>
+std::vector<const V*> HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::getMany(const std::vector<Q>& keys) const {
+    std::vector<const V*> results(keys.size(), nullptr);
+    size_t hashes[PREFETCH_BATCH];
+    
+    for (size_t start = 0; start < keys.size(); start += PREFETCH_BATCH) {
+        size_t end = std::min(start + PREFETCH_BATCH, keys.size());
+        // Сначала все хеши и предвыборки порции, потом зависимые чтения
+        for (size_t i = start; i < end; i++) {
+            hashes[i - start] = hashOf(keys[i]);
+            prefetchSlot(table, hashes[i - start]);
+            prefetchSlot(oldTable, hashes[i - start]);
+        }
+        for (size_t i = start; i < end; i++) {
+            bool inOld;
+            size_t index;
+            if (locate(keys[i], hashes[i - start], inOld, index)) {
+                results[i] = &(inOld ? oldTable : table)[index].value;
+            }
+        }
+    }
+    return results;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::putMany(const std::vector<std::pair<K, V>>& items) {
+    size_t hashes[PREFETCH_BATCH];
+    
+    for (size_t start = 0; start < items.size(); start += PREFETCH_BATCH) {
+        size_t end = std::min(start + PREFETCH_BATCH, items.size());
+        for (size_t i = start; i < end; i++) {
+            hashes[i - start] = hashOf(items[i].first);
+            prefetchSlot(table, hashes[i - start]);
+            prefetchSlot(oldTable, hashes[i - start]);
+        }
+        // Рост таблицы посреди порции лишь обесценивает предвыборку:
+        // слоты ищутся заново по сохранённым хешам
+        for (size_t i = start; i < end; i++) {
+            putHashed(items[i].first, items[i].second, hashes[i - start]);
+        }
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+bool HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::remove(const K& key) {
+    migrateStep();
+    
+    bool inOld;
+    size_t index;
+    if (locate(key, hashOf(key), inOld, index)) {
+        eraseAt(inOld ? oldTable : table, index);
         count--;
         return true;
     }
     return false;
 }
 
-template<typename K, typename V>
-void HashMap<K, V>::clear() {
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::clear() {
     for (auto& entry : table) {
         entry.occupied = false;
+        entry.dist = 0;
     }
+    std::vector<Entry>().swap(oldTable);
+    migrated = 0;
     count = 0;
 }
 
-template<typename K, typename V>
-size_t HashMap<K, V>::size() const {
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+size_t HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::size() const {
     return count;
 }
 
-template<typename K, typename V>
-bool HashMap<K, V>::empty() const {
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+bool HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::empty() const {
     return count == 0;
 }
 
-template<typename K, typename V>
-void HashMap<K, V>::print(std::ostream& os) const {
-    os << "HashMap {\n";
-    for (size_t i = 0; i < capacity; i++) {
-        if (table[i].occupied) {
-            os << "  [" << i << "] " << table[i].key 
-               << " => " << table[i].value << "\n";
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+size_t HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::bucketCount() const {
+    return capacity;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+double HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::loadFactor() const {
+    return capacity == 0 ? 0.0 : static_cast<double>(count) / static_cast<double>(capacity);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+double HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::maxLoadFactor() const {
+    return maxLoad;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::setMaxLoadFactor(double factor) {
+    if (!(factor > 0.0 && factor < 1.0)) {
+        throw std::invalid_argument("Максимальная заполненность должна быть в интервале (0, 1)");
+    }
+    maxLoad = factor;
+    if (static_cast<double>(count) > maxLoad * static_cast<double>(capacity)) {
+        rehash(capacityFor(count));
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::reserve(size_t n) {
+    size_t needed = capacityFor(n);
+    if (needed > capacity) {
+        rehash(needed);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::shrink_to_fit() {
+    size_t needed = capacityFor(count);
+    if (needed < capacity) {
+        rehash(needed);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+typename HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::RehashMode HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::rehashMode() const {
+    return mode;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::setRehashMode(RehashMode newMode) {
+    if (newMode == FULL_REHASH) {
+        finishRehash();
+    }
+    mode = newMode;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+bool HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::isRehashing() const {
+    return !oldTable.empty();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+size_t HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::maxProbeDistance() const {
+    uint32_t longest = 0;
+    for (const auto* t : {&table, &oldTable}) {
+        for (const auto& entry : *t) {
+            if (entry.occupied) {
+                longest = std::max(longest, entry.dist);
+            }
         }
     }
-    os << "} (size: " << count << ")";
+    return longest;
 }
 
-// Бинарная сериализация для HashMap<string, string>
-template<>
-inline void HashMap<std::string, std::string>::saveToBinary(std::ofstream& out) const {
-    // Записываем количество элементов
-    uint32_t sz = static_cast<uint32_t>(count);
-    out.write(reinterpret_cast<const char*>(&sz), sizeof(sz));
-    
-    // Записываем каждую пару ключ-значение
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::print(std::ostream& os) const {
+    os << "HashMap {\n";
     for (size_t i = 0; i < capacity; i++) {
         if (table[i].occupied) {
-            // Записываем ключ
-            uint32_t keyLen = static_cast<uint32_t>(table[i].key.length());
-            out.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
-            out.write(table[i].key.c_str(), keyLen);
-            
-            // Записываем значение
-            uint32_t valLen = static_cast<uint32_t>(table[i].value.length());
-            out.write(reinterpret_cast<const char*>(&valLen), sizeof(valLen));
-            out.write(table[i].value.c_str(), valLen);
+            os << "  [" << i << "] " << table[i].key 
+               << " => " << table[i].value << "\n";
         }
     }
-}
-
-template<>
-inline void HashMap<std::string, std::string>::loadFromBinary(std::ifstream& in) {
-    clear();
-    
-    // Читаем количество элементов
-    uint32_t sz;
-    in.read(reinterpret_cast<char*>(&sz), sizeof(sz));
-    
-    // Читаем каждую пару
-    for (uint32_t i = 0; i < sz; i++) {
-        // Читаем ключ
-        uint32_t keyLen;
-        in.read(reinterpret_cast<char*>(&keyLen), sizeof(keyLen));
-        std::string key(keyLen, '\0');
-        in.read(&key[0], keyLen);
-        
-        // Читаем значение
-        uint32_t valLen;
-        in.read(reinterpret_cast<char*>(&valLen), sizeof(valLen));
-        std::string value(valLen, '\0');
-        in.read(&value[0], valLen);
-        
-        put(key, value);
+    for (size_t i = 0; i < oldTable.size(); i++) {
+        if (oldTable[i].occupied) {
+            os << "  [old " << i << "] " << oldTable[i].key 
+               << " => " << oldTable[i].value << "\n";
+        }
     }
+    os << "} (size: " << count << ")";
 }
 
-// Общий шаблон для других типов
-template<typename K, typename V>
-void HashMap<K, V>::saveToBinary(std::ofstream& out) const {
+// Бинарная сериализация: количество, затем пары ключ-значение
+// (строки - длина + данные, POD-типы побайтно)
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::saveToBinary(std::ofstream& out) const {
     uint32_t sz = static_cast<uint32_t>(count);
     out.write(reinterpret_cast<const char*>(&sz), sizeof(sz));
     
-    for (size_t i = 0; i < capacity; i++) {
-        if (table[i].occupied) {
-            out.write(reinterpret_cast<const char*>(&table[i].key), sizeof(K));
-            out.write(reinterpret_cast<const char*>(&table[i].value), sizeof(V));
+    // Включая ещё не перенесённые из oldTable пары
+    for (const auto* t : {&table, &oldTable}) {
+        for (const auto& entry : *t) {
+            if (!entry.occupied) continue;
+            writeValue(out, entry.key);
+            writeValue(out, entry.value);
         }
     }
 }
 
-template<typename K, typename V>
-void HashMap<K, V>::loadFromBinary(std::ifstream& in) {
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Probing, typename Reduction>
+void HashMap<K, V, Hash, KeyEqual, Probing, Reduction>::loadFromBinary(std::ifstream& in) {
     clear();
-    uint32_t sz;
+    uint32_t sz = 0;
     in.read(reinterpret_cast<char*>(&sz), sizeof(sz));
+    if (!in) {
+        throw std::runtime_error("Повреждённый снимок хеш-таблицы");
+    }
+    reserve(std::min<size_t>(sz, MAX_PRESIZED_ITEMS));
     
     for (uint32_t i = 0; i < sz; i++) {
         K key;
         V value;
-        in.read(reinterpret_cast<char*>(&key), sizeof(K));
-        in.read(reinterpret_cast<char*>(&value), sizeof(V));
+        readValue(in, key);
+        readValue(in, value);
+        if (!in) {
+            // Частично загруженную таблицу не оставляем
+            clear();
+            throw std::runtime_error("Повреждённый снимок хеш-таблицы");
+        }
         put(key, value);
     }
 }
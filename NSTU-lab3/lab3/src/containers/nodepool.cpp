@@ -0,0 +1,92 @@
+#ifndef NODEPOOL_CPP
+#define NODEPOOL_CPP
+
+#include <new>
+#include <utility>
+#include "trees.h"
+
+template<typename NodeT>
+NodePool<NodeT>::NodePool()
+    : cursor(nullptr), slabEnd(nullptr), freeList(nullptr), slotCount(0) {}
+
+template<typename NodeT>
+NodePool<NodeT>::NodePool(NodePool&& other) noexcept
+    : slabs(std::move(other.slabs)), cursor(other.cursor), slabEnd(other.slabEnd),
+      freeList(other.freeList), slotCount(other.slotCount) {
+    other.slabs.clear();
+    other.cursor = other.slabEnd = other.freeList = nullptr;
+    other.slotCount = 0;
+}
+
+template<typename NodeT>
+NodePool<NodeT>& NodePool<NodeT>::operator=(NodePool&& other) noexcept {
+    if (this != &other) {
+        slabs = std::move(other.slabs);
+        cursor = other.cursor;
+        slabEnd = other.slabEnd;
+        freeList = other.freeList;
+        slotCount = other.slotCount;
+        other.slabs.clear();
+        other.cursor = other.slabEnd = other.freeList = nullptr;
+        other.slotCount = 0;
+    }
+    return *this;
+}
+
+template<typename NodeT>
+typename NodePool<NodeT>::Slot* NodePool<NodeT>::allocateSlot() {
+    if (freeList) {
+        Slot* slot = freeList;
+        freeList = slot->next;
+        return slot;
+    }
+    if (cursor == slabEnd) {
+        size_t slabSize = slabs.empty() ? FIRST_SLAB : std::min(slotCount, MAX_SLAB);
+        slabs.emplace_back(new Slot[slabSize]);
+        cursor = slabs.back().get();
+        slabEnd = cursor + slabSize;
+        slotCount += slabSize;
+    }
+    return cursor++;
+}
+
+template<typename NodeT>
+template<typename... Args>
+NodeT* NodePool<NodeT>::create(Args&&... args) {
+    Slot* slot = allocateSlot();
+    try {
+        return new (slot->storage) NodeT(std::forward<Args>(args)...);
+    } catch (...) {
+        slot->next = freeList;
+        freeList = slot;
+        throw;
+    }
+}
+
+template<typename NodeT>
+void NodePool<NodeT>::destroy(NodeT* node) {
+    node->~NodeT();
+    // storage - первый член объединения, адрес ячейки совпадает с адресом узла
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->next = freeList;
+    freeList = slot;
+}
+
+template<typename NodeT>
+void NodePool<NodeT>::release() {
+    std::vector<std::unique_ptr<Slot[]>>().swap(slabs);
+    cursor = slabEnd = freeList = nullptr;
+    slotCount = 0;
+}
+
+template<typename NodeT>
+size_t NodePool<NodeT>::capacity() const {
+    return slotCount;
+}
+
+template<typename NodeT>
+size_t NodePool<NodeT>::memoryUsage() const {
+    return slotCount * sizeof(Slot) + slabs.capacity() * sizeof(std::unique_ptr<Slot[]>);
+}
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef READMOSTLY_CPP
+#define READMOSTLY_CPP
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include "hash.h"
+
+// Реализация EpochDomain
+
+inline EpochDomain& EpochDomain::instance() {
+    static EpochDomain domain;
+    return domain;
+}
+
+inline EpochDomain::ReaderHandle::ReaderHandle(EpochDomain& owner)
+    : domain(owner), index(0), depth(0) {
+    for (size_t i = 0; i < MAX_READERS; i++) {
+        bool expected = false;
+        if (domain.readers[i].used.compare_exchange_strong(expected, true)) {
+            index = i;
+            return;
+        }
+    }
+    throw std::runtime_error("Слишком много потоков-читателей");
+}
+
+inline EpochDomain::ReaderHandle::~ReaderHandle() {
+    domain.readers[index].epoch.store(IDLE, std::memory_order_release);
+    domain.readers[index].used.store(false, std::memory_order_release);
+}
+
+inline EpochDomain::ReaderHandle& EpochDomain::localHandle() {
+    thread_local ReaderHandle handle(*this);
+    return handle;
+}
+
+inline void EpochDomain::enter() {
+    ReaderHandle& handle = localHandle();
+    if (handle.depth++ > 0) {
+        return;
+    }
+    uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+    readers[handle.index].epoch.store(epoch, std::memory_order_relaxed);
+    // Парный барьер к барьеру писателя в reclaim(): либо писатель увидит
+    // эту эпоху, либо читатель увидит уже опубликованную новую версию
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+inline void EpochDomain::leave() {
+    ReaderHandle& handle = localHandle();
+    if (--handle.depth == 0) {
+        readers[handle.index].epoch.store(IDLE, std::memory_order_release);
+    }
+}
+
+inline uint64_t EpochDomain::currentEpoch() const {
+    return globalEpoch.load(std::memory_order_acquire);
+}
+
+inline void EpochDomain::advance() {
+    globalEpoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+inline uint64_t EpochDomain::minActiveEpoch() const {
+    uint64_t minimum = std::numeric_limits<uint64_t>::max();
+    for (size_t i = 0; i < MAX_READERS; i++) {
+        uint64_t epoch = readers[i].epoch.load(std::memory_order_acquire);
+        if (epoch != IDLE && epoch < minimum) {
+            minimum = epoch;
+        }
+    }
+    return minimum;
+}
+
+// Реализация ReadMostlyHashMap
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+ReadMostlyHashMap<K, V, Hash, KeyEqual>::Table::Table(size_t capacity)
+    : buckets(new std::atomic<Node*>[capacity]), mask(capacity - 1) {
+    for (size_t i = 0; i < capacity; i++) {
+        buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+ReadMostlyHashMap<K, V, Hash, KeyEqual>::ReadMostlyHashMap(size_t initialCapacity) : count(0) {
+    size_t capacity = 8;
+    while (capacity < initialCapacity) {
+        capacity *= 2;
+    }
+    current.store(new Table(capacity), std::memory_order_release);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+ReadMostlyHashMap<K, V, Hash, KeyEqual>::~ReadMostlyHashMap() {
+    // Параллельных читателей при разрушении быть не должно
+    freeTable(current.load(std::memory_order_acquire));
+    for (const Retired& item : retired) {
+        if (item.table) freeTable(item.table);
+        else freeChain(item.chain);
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ReadMostlyHashMap<K, V, Hash, KeyEqual>::bucketOf(const Table* t, size_t hash) const {
+    return static_cast<size_t>(mixHash64(static_cast<uint64_t>(hash))) & t->mask;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+const typename ReadMostlyHashMap<K, V, Hash, KeyEqual>::Node*
+ReadMostlyHashMap<K, V, Hash, KeyEqual>::findNode(const Table* t, const K& key, size_t hash) const {
+    const Node* node = t->buckets[bucketOf(t, hash)].load(std::memory_order_acquire);
+    while (node) {
+        if (node->hash == hash && keyEqual(node->key, key)) {
+            return node;
+        }
+        node = node->next;
+    }
+    return nullptr;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+typename ReadMostlyHashMap<K, V, Hash, KeyEqual>::Node*
+ReadMostlyHashMap<K, V, Hash, KeyEqual>::copyChainWithout(const Node* head, const K& skip, size_t hash) {
+    Node* copy = nullptr;
+    for (const Node* node = head; node; node = node->next) {
+        if (node->hash == hash && keyEqual(node->key, skip)) continue;
+        copy = new Node{node->key, node->value, node->hash, copy};
+    }
+    return copy;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ReadMostlyHashMap<K, V, Hash, KeyEqual>::freeChain(Node* head) {
+    while (head) {
+        Node* next = head->next;
+        delete head;
+        head = next;
+    }
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ReadMostlyHashMap<K, V, Hash, KeyEqual>::freeTable(Table* t) {
+    for (size_t i = 0; i <= t->mask; i++) {
+        freeChain(t->buckets[i].load(std::memory_order_relaxed));
+    }
+    delete t;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ReadMostlyHashMap<K, V, Hash, KeyEqual>::retire(Table* t, Node* chain) {
+    if (!t && !chain) {
+        return;
+    }
+    EpochDomain& domain = EpochDomain::instance();
+    retired.push_back(Retired{t, chain, domain.currentEpoch()});
+    domain.advance();
+    reclaim();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ReadMostlyHashMap<K, V, Hash, KeyEqual>::reclaim() {
+    // Парный барьер к EpochDomain::enter()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t oldestReader = EpochDomain::instance().minActiveEpoch();
+
+    // Версию мог видеть только читатель, вошедший не позже её удаления
+    size_t kept = 0;
+    for (const Retired& item : retired) {
+        if (item.epoch < oldestReader) {
+            if (item.table) freeTable(item.table);
+            else freeChain(item.chain);
+        } else {
+            retired[kept++] = item;
+        }
+    }
+    retired.resize(kept);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ReadMostlyHashMap<K, V, Hash, KeyEqual>::grow() {
+    Table* old = current.load(std::memory_order_relaxed);
+    Table* bigger = new Table((old->mask + 1) * 2);
+    for (size_t i = 0; i <= old->mask; i++) {
+        for (const Node* node = old->buckets[i].load(std::memory_order_relaxed); node; node = node->next) {
+            std::atomic<Node*>& bucket = bigger->buckets[bucketOf(bigger, node->hash)];
+            bucket.store(new Node{node->key, node->value, node->hash,
+                                  bucket.load(std::memory_order_relaxed)},
+                         std::memory_order_relaxed);
+        }
+    }
+    // Читатели старой таблицы дочитают её, новые придут в новую
+    current.store(bigger, std::memory_order_release);
+    retire(old, nullptr);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V ReadMostlyHashMap<K, V, Hash, KeyEqual>::get(const K& key) const {
+    V value;
+    if (tryGet(key, value)) {
+        return value;
+    }
+    throw std::runtime_error("Ключ не найден");
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ReadMostlyHashMap<K, V, Hash, KeyEqual>::tryGet(const K& key, V& value) const {
+    size_t hash = hasher(key);
+    EpochGuard guard;
+    const Node* node = findNode(current.load(std::memory_order_acquire), key, hash);
+    if (!node) {
+        return false;
+    }
+    value = node->value;
+    return true;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ReadMostlyHashMap<K, V, Hash, KeyEqual>::contains(const K& key) const {
+    size_t hash = hasher(key);
+    EpochGuard guard;
+    return findNode(current.load(std::memory_order_acquire), key, hash) != nullptr;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ReadMostlyHashMap<K, V, Hash, KeyEqual>::put(const K& key, const V& value) {
+    std::lock_guard<std::mutex> guard(writeLock);
+    size_t hash = hasher(key);
+    Table* t = current.load(std::memory_order_relaxed);
+    bool exists = findNode(t, key, hash) != nullptr;
+    if (!exists && count.load(std::memory_order_relaxed) + 1 > t->mask + 1) {
+        grow();
+        t = current.load(std::memory_order_relaxed);
+    }
+
+    // Новая версия цепочки: изменённый ключ впереди, остальные - копии
+    std::atomic<Node*>& bucket = t->buckets[bucketOf(t, hash)];
+    Node* old = bucket.load(std::memory_order_relaxed);
+    Node* updated = new Node{key, value, hash, copyChainWithout(old, key, hash)};
+    bucket.store(updated, std::memory_order_release);
+    if (!exists) {
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    retire(nullptr, old);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ReadMostlyHashMap<K, V, Hash, KeyEqual>::remove(const K& key) {
+    std::lock_guard<std::mutex> guard(writeLock);
+    size_t hash = hasher(key);
+    Table* t = current.load(std::memory_order_relaxed);
+    if (!findNode(t, key, hash)) {
+        return false;
+    }
+    std::atomic<Node*>& bucket = t->buckets[bucketOf(t, hash)];
+    Node* old = bucket.load(std::memory_order_relaxed);
+    bucket.store(copyChainWithout(old, key, hash), std::memory_order_release);
+    count.store(count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    retire(nullptr, old);
+    return true;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void ReadMostlyHashMap<K, V, Hash, KeyEqual>::clear() {
+    std::lock_guard<std::mutex> guard(writeLock);
+    Table* old = current.load(std::memory_order_relaxed);
+    current.store(new Table(old->mask + 1), std::memory_order_release);
+    count.store(0, std::memory_order_relaxed);
+    retire(old, nullptr);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ReadMostlyHashMap<K, V, Hash, KeyEqual>::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool ReadMostlyHashMap<K, V, Hash, KeyEqual>::empty() const {
+    return size() == 0;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ReadMostlyHashMap<K, V, Hash, KeyEqual>::bucketCount() const {
+    EpochGuard guard;
+    return current.load(std::memory_order_acquire)->mask + 1;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t ReadMostlyHashMap<K, V, Hash, KeyEqual>::pendingReclamation() {
+    std::lock_guard<std::mutex> guard(writeLock);
+    reclaim();
+    return retired.size();
+}
+
+#endif
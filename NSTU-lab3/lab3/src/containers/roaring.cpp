@@ -0,0 +1,631 @@
+#ifndef ROARING_CPP
+#define ROARING_CPP
+
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include "hash.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Реализация BitmapOps: хвост, не кратный 128 битам, и сборки без SSE2
+// обрабатываются по слову
+
+inline uint32_t BitmapOps::unite(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 2 <= words; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(x, y));
+    }
+#endif
+    for (; i < words; i++) {
+        out[i] = a[i] | b[i];
+    }
+    return cardinality(out, words);
+}
+
+inline uint32_t BitmapOps::intersect(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 2 <= words; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(x, y));
+    }
+#endif
+    for (; i < words; i++) {
+        out[i] = a[i] & b[i];
+    }
+    return cardinality(out, words);
+}
+
+inline uint32_t BitmapOps::subtract(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 2 <= words; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_andnot_si128(y, x));
+    }
+#endif
+    for (; i < words; i++) {
+        out[i] = a[i] & ~b[i];
+    }
+    return cardinality(out, words);
+}
+
+inline uint32_t BitmapOps::cardinality(const uint64_t* words, size_t count) {
+    // Карта блока - 8 КБ: после пословной операции она ещё в L1
+    uint32_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += static_cast<uint32_t>(__builtin_popcountll(words[i]));
+    }
+    return total;
+}
+
+// Реализация RoaringSet
+
+template<typename T>
+RoaringSet<T>::RoaringSet() : count(0) {}
+
+template<typename T>
+uint32_t RoaringSet<T>::toBits(T value) {
+    return static_cast<uint32_t>(static_cast<Unsigned>(static_cast<Unsigned>(value) ^ SIGN_FLIP));
+}
+
+template<typename T>
+T RoaringSet<T>::fromBits(uint32_t bits) {
+    return static_cast<T>(static_cast<Unsigned>(static_cast<Unsigned>(bits) ^ SIGN_FLIP));
+}
+
+template<typename T>
+size_t RoaringSet<T>::lowerBound(uint16_t key) const {
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    return static_cast<size_t>(it - containers.begin());
+}
+
+template<typename T>
+const typename RoaringSet<T>::Container* RoaringSet<T>::findContainer(uint16_t key) const {
+    size_t index = lowerBound(key);
+    if (index < containers.size() && containers[index].key == key) {
+        return &containers[index];
+    }
+    return nullptr;
+}
+
+template<typename T>
+typename RoaringSet<T>::Container& RoaringSet<T>::containerFor(uint16_t key) {
+    size_t index = lowerBound(key);
+    if (index == containers.size() || containers[index].key != key) {
+        containers.insert(containers.begin() + index, Container{key, ARRAY, 0, {}, {}, {}});
+    }
+    return containers[index];
+}
+
+template<typename T>
+size_t RoaringSet<T>::findRun(const std::vector<Run>& runs, uint16_t low) {
+    // Последний отрезок, начинающийся не позже low; runs.size(), если такого нет
+    auto it = std::upper_bound(runs.begin(), runs.end(), low,
+                               [](uint16_t v, const Run& run) { return v < run.start; });
+    return it == runs.begin() ? runs.size() : static_cast<size_t>(it - runs.begin()) - 1;
+}
+
+template<typename T>
+bool RoaringSet<T>::containerContains(const Container& c, uint16_t low) {
+    switch (c.kind) {
+        case ARRAY:
+            return std::binary_search(c.array.begin(), c.array.end(), low);
+        case BITMAP:
+            return (c.bitmap[low >> 6] >> (low & 63)) & 1;
+        default: {
+            size_t i = findRun(c.runs, low);
+            return i < c.runs.size() && low - c.runs[i].start <= c.runs[i].length;
+        }
+    }
+}
+
+template<typename T>
+bool RoaringSet<T>::containerAdd(Container& c, uint16_t low) {
+    if (c.kind == ARRAY) {
+        auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (it != c.array.end() && *it == low) {
+            return false;
+        }
+        if (c.cardinality < ARRAY_MAX) {
+            c.array.insert(it, low);
+            c.cardinality++;
+            return true;
+        }
+        toBitmap(c);
+    }
+    if (c.kind == BITMAP) {
+        uint64_t& word = c.bitmap[low >> 6];
+        uint64_t bit = uint64_t(1) << (low & 63);
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        c.cardinality++;
+        return true;
+    }
+
+    size_t i = findRun(c.runs, low);
+    bool hasPrev = i < c.runs.size();
+    if (hasPrev && low - c.runs[i].start <= c.runs[i].length) {
+        return false;
+    }
+    size_t next = hasPrev ? i + 1 : 0;
+    bool joinsPrev = hasPrev && c.runs[i].start + c.runs[i].length + 1 == low;
+    bool joinsNext = next < c.runs.size() && c.runs[next].start == low + 1;
+    if (joinsPrev && joinsNext) {
+        c.runs[i].length = static_cast<uint16_t>(c.runs[i].length + c.runs[next].length + 2);
+        c.runs.erase(c.runs.begin() + next);
+    } else if (joinsPrev) {
+        c.runs[i].length++;
+    } else if (joinsNext) {
+        c.runs[next].start--;
+        c.runs[next].length++;
+    } else {
+        c.runs.insert(c.runs.begin() + next, Run{low, 0});
+    }
+    c.cardinality++;
+    normalize(c);
+    return true;
+}
+
+template<typename T>
+bool RoaringSet<T>::containerRemove(Container& c, uint16_t low) {
+    if (c.kind == ARRAY) {
+        auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (it == c.array.end() || *it != low) {
+            return false;
+        }
+        c.array.erase(it);
+        c.cardinality--;
+        return true;
+    }
+    if (c.kind == BITMAP) {
+        uint64_t& word = c.bitmap[low >> 6];
+        uint64_t bit = uint64_t(1) << (low & 63);
+        if (!(word & bit)) {
+            return false;
+        }
+        word &= ~bit;
+        c.cardinality--;
+        normalize(c);
+        return true;
+    }
+
+    size_t i = findRun(c.runs, low);
+    if (i == c.runs.size() || low - c.runs[i].start > c.runs[i].length) {
+        return false;
+    }
+    Run& run = c.runs[i];
+    uint32_t last = run.start + run.length;
+    if (run.length == 0) {
+        c.runs.erase(c.runs.begin() + i);
+    } else if (low == run.start) {
+        run.start++;
+        run.length--;
+    } else if (low == last) {
+        run.length--;
+    } else {
+        // Удаление из середины делит отрезок на два
+        Run tail{static_cast<uint16_t>(low + 1), static_cast<uint16_t>(last - low - 1)};
+        run.length = static_cast<uint16_t>(low - run.start - 1);
+        c.runs.insert(c.runs.begin() + i + 1, tail);
+    }
+    c.cardinality--;
+    normalize(c);
+    return true;
+}
+
+template<typename T>
+void RoaringSet<T>::setRange(std::vector<uint64_t>& bitmap, uint32_t first, uint32_t last) {
+    size_t firstWord = first >> 6;
+    size_t lastWord = last >> 6;
+    uint64_t firstMask = ~uint64_t(0) << (first & 63);
+    uint64_t lastMask = ~uint64_t(0) >> (63 - (last & 63));
+    if (firstWord == lastWord) {
+        bitmap[firstWord] |= firstMask & lastMask;
+        return;
+    }
+    bitmap[firstWord] |= firstMask;
+    for (size_t w = firstWord + 1; w < lastWord; w++) {
+        bitmap[w] = ~uint64_t(0);
+    }
+    bitmap[lastWord] |= lastMask;
+}
+
+template<typename T>
+template<typename F>
+void RoaringSet<T>::forEachLow(const Container& c, F f) {
+    switch (c.kind) {
+        case ARRAY:
+            for (uint16_t low : c.array) {
+                f(low);
+            }
+            break;
+        case BITMAP:
+            for (size_t w = 0; w < BITMAP_WORDS; w++) {
+                uint64_t word = c.bitmap[w];
+                while (word) {
+                    f(static_cast<uint16_t>(w * 64 + static_cast<size_t>(__builtin_ctzll(word))));
+                    word &= word - 1;
+                }
+            }
+            break;
+        default:
+            for (const Run& run : c.runs) {
+                for (uint32_t low = run.start; low <= uint32_t(run.start) + run.length; low++) {
+                    f(static_cast<uint16_t>(low));
+                }
+            }
+            break;
+    }
+}
+
+template<typename T>
+void RoaringSet<T>::toArray(Container& c) {
+    std::vector<uint16_t> values;
+    values.reserve(c.cardinality);
+    forEachLow(c, [&values](uint16_t low) { values.push_back(low); });
+    c.array.swap(values);
+    std::vector<uint64_t>().swap(c.bitmap);
+    std::vector<Run>().swap(c.runs);
+    c.kind = ARRAY;
+}
+
+template<typename T>
+void RoaringSet<T>::toBitmap(Container& c) {
+    std::vector<uint64_t> words;
+    wordsOf(c, words);
+    c.bitmap.swap(words);
+    std::vector<uint16_t>().swap(c.array);
+    std::vector<Run>().swap(c.runs);
+    c.kind = BITMAP;
+}
+
+template<typename T>
+std::vector<typename RoaringSet<T>::Run> RoaringSet<T>::runsOf(const Container& c) {
+    if (c.kind == RUNS) {
+        return c.runs;
+    }
+    std::vector<Run> runs;
+    forEachLow(c, [&runs](uint16_t low) {
+        if (!runs.empty() && runs.back().start + runs.back().length + 1 == low) {
+            runs.back().length++;
+        } else {
+            runs.push_back(Run{low, 0});
+        }
+    });
+    return runs;
+}
+
+template<typename T>
+size_t RoaringSet<T>::containerBytes(const Container& c) {
+    return c.array.capacity() * sizeof(uint16_t) + c.bitmap.capacity() * sizeof(uint64_t) +
+           c.runs.capacity() * sizeof(Run);
+}
+
+template<typename T>
+void RoaringSet<T>::normalize(Container& c) {
+    if (c.kind == RUNS) {
+        size_t runBytes = c.runs.size() * sizeof(Run);
+        size_t otherBytes = std::min<size_t>(c.cardinality * sizeof(uint16_t),
+                                             BITMAP_WORDS * sizeof(uint64_t));
+        if (runBytes <= otherBytes) {
+            return;
+        }
+    }
+    if (c.cardinality <= ARRAY_MAX) {
+        if (c.kind != ARRAY) toArray(c);
+    } else if (c.kind != BITMAP) {
+        toBitmap(c);
+    }
+}
+
+template<typename T>
+void RoaringSet<T>::makeRuns(Container& c, std::vector<Run> runs) {
+    size_t currentBytes = c.kind == ARRAY ? c.cardinality * sizeof(uint16_t)
+                                          : BITMAP_WORDS * sizeof(uint64_t);
+    if (c.kind == RUNS || runs.size() * sizeof(Run) >= currentBytes) {
+        return;
+    }
+    c.runs = std::move(runs);
+    std::vector<uint16_t>().swap(c.array);
+    std::vector<uint64_t>().swap(c.bitmap);
+    c.kind = RUNS;
+}
+
+template<typename T>
+const uint64_t* RoaringSet<T>::wordsOf(const Container& c, std::vector<uint64_t>& scratch) {
+    if (c.kind == BITMAP) {
+        return c.bitmap.data();
+    }
+    scratch.assign(BITMAP_WORDS, 0);
+    if (c.kind == ARRAY) {
+        for (uint16_t low : c.array) {
+            scratch[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+    } else {
+        for (const Run& run : c.runs) {
+            setRange(scratch, run.start, uint32_t(run.start) + run.length);
+        }
+    }
+    return scratch.data();
+}
+
+template<typename T>
+typename RoaringSet<T>::Container RoaringSet<T>::combineRuns(const Container& a, const Container& b, Op op) {
+    std::vector<Run> out;
+    // Отрезки приходят по возрастанию; касающиеся склеиваются
+    auto push = [&out](uint32_t first, uint32_t last) {
+        if (!out.empty() && uint32_t(out.back().start) + out.back().length + 1 >= first) {
+            uint32_t end = std::max<uint32_t>(uint32_t(out.back().start) + out.back().length, last);
+            out.back().length = static_cast<uint16_t>(end - out.back().start);
+        } else {
+            out.push_back(Run{static_cast<uint16_t>(first), static_cast<uint16_t>(last - first)});
+        }
+    };
+    const std::vector<Run>& x = a.runs;
+    const std::vector<Run>& y = b.runs;
+    size_t i = 0, j = 0;
+    if (op == UNION) {
+        while (i < x.size() || j < y.size()) {
+            bool fromX = j == y.size() || (i < x.size() && x[i].start <= y[j].start);
+            const Run& run = fromX ? x[i++] : y[j++];
+            push(run.start, uint32_t(run.start) + run.length);
+        }
+    } else if (op == INTERSECTION) {
+        while (i < x.size() && j < y.size()) {
+            uint32_t xEnd = uint32_t(x[i].start) + x[i].length;
+            uint32_t yEnd = uint32_t(y[j].start) + y[j].length;
+            uint32_t first = std::max(x[i].start, y[j].start);
+            uint32_t last = std::min(xEnd, yEnd);
+            if (first <= last) push(first, last);
+            if (xEnd < yEnd) i++;
+            else j++;
+        }
+    } else {
+        for (const Run& run : x) {
+            uint32_t first = run.start;
+            uint32_t last = uint32_t(run.start) + run.length;
+            while (j < y.size() && uint32_t(y[j].start) + y[j].length < first) j++;
+            for (size_t k = j; first <= last && k < y.size() && y[k].start <= last; k++) {
+                if (y[k].start > first) push(first, y[k].start - 1u);
+                first = uint32_t(y[k].start) + y[k].length + 1;
+            }
+            if (first <= last) push(first, last);
+        }
+    }
+
+    uint32_t cardinality = 0;
+    for (const Run& run : out) {
+        cardinality += uint32_t(run.length) + 1;
+    }
+    Container result{a.key, RUNS, cardinality, {}, {}, std::move(out)};
+    normalize(result);
+    return result;
+}
+
+template<typename T>
+typename RoaringSet<T>::Container RoaringSet<T>::combine(const Container& a, const Container& b, Op op) {
+    if (a.kind == RUNS && b.kind == RUNS) {
+        return combineRuns(a, b, op);
+    }
+    Container result{a.key, ARRAY, 0, {}, {}, {}};
+    if (a.kind == ARRAY && b.kind == ARRAY && op != UNION &&
+        std::max(a.cardinality, b.cardinality) < GALLOP_RATIO * std::min(a.cardinality, b.cardinality)) {
+        // Массивы близкого размера - слиянием за один проход
+        if (op == INTERSECTION) {
+            std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                  std::back_inserter(result.array));
+        } else {
+            std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                std::back_inserter(result.array));
+        }
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+        return result;
+    }
+    if (op == INTERSECTION && (a.kind == ARRAY || b.kind == ARRAY)) {
+        // Обходится массив, элементы проверяются в другом блоке
+        bool fromA = a.kind == ARRAY && (b.kind != ARRAY || a.cardinality <= b.cardinality);
+        const Container& small = fromA ? a : b;
+        const Container& other = fromA ? b : a;
+        for (uint16_t low : small.array) {
+            if (containerContains(other, low)) result.array.push_back(low);
+        }
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+        return result;
+    }
+    if (op == DIFFERENCE && a.kind == ARRAY) {
+        for (uint16_t low : a.array) {
+            if (!containerContains(b, low)) result.array.push_back(low);
+        }
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+        return result;
+    }
+    if (op == UNION && a.kind == ARRAY && b.kind == ARRAY) {
+        result.array.reserve(a.array.size() + b.array.size());
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(result.array));
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+        normalize(result);
+        return result;
+    }
+
+    // Остальные сочетания - пословно над битовыми картами
+    std::vector<uint64_t> scratchA, scratchB;
+    const uint64_t* x = wordsOf(a, scratchA);
+    const uint64_t* y = wordsOf(b, scratchB);
+    result.kind = BITMAP;
+    result.bitmap.resize(BITMAP_WORDS);
+    if (op == UNION) {
+        result.cardinality = BitmapOps::unite(x, y, result.bitmap.data(), BITMAP_WORDS);
+    } else if (op == INTERSECTION) {
+        result.cardinality = BitmapOps::intersect(x, y, result.bitmap.data(), BITMAP_WORDS);
+    } else {
+        result.cardinality = BitmapOps::subtract(x, y, result.bitmap.data(), BITMAP_WORDS);
+    }
+    normalize(result);
+    return result;
+}
+
+template<typename T>
+RoaringSet<T> RoaringSet<T>::combineSets(const RoaringSet& a, const RoaringSet& b, Op op) {
+    RoaringSet result;
+    const std::vector<Container>& x = a.containers;
+    const std::vector<Container>& y = b.containers;
+    size_t i = 0, j = 0;
+    while (i < x.size() || j < y.size()) {
+        if (op == INTERSECTION && (i == x.size() || j == y.size())) break;
+        if (op == DIFFERENCE && i == x.size()) break;
+
+        if (j == y.size() || (i < x.size() && x[i].key < y[j].key)) {
+            if (op != INTERSECTION) result.containers.push_back(x[i]);
+            i++;
+        } else if (i == x.size() || y[j].key < x[i].key) {
+            if (op == UNION) result.containers.push_back(y[j]);
+            j++;
+        } else {
+            Container combined = combine(x[i], y[j], op);
+            if (combined.cardinality > 0) result.containers.push_back(std::move(combined));
+            i++;
+            j++;
+        }
+    }
+    for (const Container& c : result.containers) {
+        result.count += c.cardinality;
+    }
+    return result;
+}
+
+template<typename T>
+void RoaringSet<T>::add(T value) {
+    uint32_t bits = toBits(value);
+    if (containerAdd(containerFor(static_cast<uint16_t>(bits >> 16)), static_cast<uint16_t>(bits))) {
+        count++;
+    }
+}
+
+template<typename T>
+void RoaringSet<T>::addRange(T first, T last) {
+    if (last < first) {
+        return;
+    }
+    uint32_t firstBits = toBits(first);
+    uint32_t lastBits = toBits(last);
+    for (uint32_t key = firstBits >> 16; key <= lastBits >> 16; key++) {
+        uint16_t low = key == firstBits >> 16 ? static_cast<uint16_t>(firstBits) : 0;
+        uint16_t high = key == lastBits >> 16 ? static_cast<uint16_t>(lastBits) : 0xFFFF;
+        Container range{static_cast<uint16_t>(key), RUNS, uint32_t(high - low) + 1, {}, {},
+                        {Run{low, static_cast<uint16_t>(high - low)}}};
+
+        Container& c = containerFor(static_cast<uint16_t>(key));
+        count -= c.cardinality;
+        c = c.cardinality == 0 ? std::move(range) : combine(c, range, UNION);
+        if (c.kind != RUNS) {
+            makeRuns(c, runsOf(c));
+        }
+        count += c.cardinality;
+    }
+}
+
+template<typename T>
+bool RoaringSet<T>::contains(T value) const {
+    uint32_t bits = toBits(value);
+    const Container* c = findContainer(static_cast<uint16_t>(bits >> 16));
+    return c && containerContains(*c, static_cast<uint16_t>(bits));
+}
+
+template<typename T>
+bool RoaringSet<T>::remove(T value) {
+    uint32_t bits = toBits(value);
+    size_t index = lowerBound(static_cast<uint16_t>(bits >> 16));
+    if (index == containers.size() || containers[index].key != static_cast<uint16_t>(bits >> 16) ||
+        !containerRemove(containers[index], static_cast<uint16_t>(bits))) {
+        return false;
+    }
+    if (containers[index].cardinality == 0) {
+        containers.erase(containers.begin() + index);
+    }
+    count--;
+    return true;
+}
+
+template<typename T>
+void RoaringSet<T>::clear() {
+    containers.clear();
+    count = 0;
+}
+
+template<typename T>
+size_t RoaringSet<T>::size() const {
+    return count;
+}
+
+template<typename T>
+bool RoaringSet<T>::empty() const {
+    return count == 0;
+}
+
+template<typename T>
+void RoaringSet<T>::optimize() {
+    for (Container& c : containers) {
+        if (c.kind != RUNS) {
+            makeRuns(c, runsOf(c));
+        }
+    }
+}
+
+template<typename T>
+size_t RoaringSet<T>::memoryUsage() const {
+    size_t total = containers.capacity() * sizeof(Container);
+    for (const Container& c : containers) {
+        total += containerBytes(c);
+    }
+    return total;
+}
+
+template<typename T>
+template<typename F>
+void RoaringSet<T>::forEach(F f) const {
+    for (const Container& c : containers) {
+        uint32_t high = uint32_t(c.key) << 16;
+        forEachLow(c, [&f, high](uint16_t low) { f(fromBits(high | low)); });
+    }
+}
+
+template<typename T>
+void RoaringSet<T>::print(std::ostream& os) const {
+    os << "RoaringSet {";
+    bool first = true;
+    forEach([&os, &first](T value) {
+        os << (first ? " " : ", ") << +value;
+        first = false;
+    });
+    os << " } (size: " << count << ")";
+}
+
+template<typename T>
+RoaringSet<T> RoaringSet<T>::unionOf(const RoaringSet& a, const RoaringSet& b) {
+    return combineSets(a, b, UNION);
+}
+
+template<typename T>
+RoaringSet<T> RoaringSet<T>::intersectionOf(const RoaringSet& a, const RoaringSet& b) {
+    return combineSets(a, b, INTERSECTION);
+}
+
+template<typename T>
+RoaringSet<T> RoaringSet<T>::differenceOf(const RoaringSet& a, const RoaringSet& b) {
+    return combineSets(a, b, DIFFERENCE);
+}
+
+#endif
@@ -1,44 +1,171 @@
 #ifndef SET_CPP
 #define SET_CPP
 
+#include <algorithm>
+#include <iterator>
+#include <thread>
 #include "hash.h"
 
-template<typename T>
-Set<T>::Set(size_t initialCapacity) : map(initialCapacity) {}
+// Реализация Set: таблица ControlTable, слот которой - сам элемент
 
-template<typename T>
-void Set<T>::add(const T& value) {
-    map.put(value, true);
+template<typename T, typename Hash, typename KeyEqual>
+Set<T, Hash, KeyEqual>::Set(size_t initialCapacity)
+    : table(initialCapacity) {}
+
+template<typename T, typename Hash, typename KeyEqual>
+void Set<T, Hash, KeyEqual>::add(const T& value) {
+    auto [slot, inserted] = table.insert(value);
+    if (inserted) {
+        *slot = value;
+    }
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+bool Set<T, Hash, KeyEqual>::contains(const T& value) const {
+    return table.find(value) != nullptr;
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+template<typename Q, typename>
+bool Set<T, Hash, KeyEqual>::contains(const Q& value) const {
+    return table.find(value) != nullptr;
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+bool Set<T, Hash, KeyEqual>::remove(const T& value) {
+    return table.erase(value);
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+void Set<T, Hash, KeyEqual>::clear() {
+    table.clear();
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+size_t Set<T, Hash, KeyEqual>::size() const {
+    return table.size();
 }
 
-template<typename T>
-bool Set<T>::contains(const T& value) const {
-    return map.contains(value);
+template<typename T, typename Hash, typename KeyEqual>
+bool Set<T, Hash, KeyEqual>::empty() const {
+    return table.size() == 0;
 }
 
-template<typename T>
-bool Set<T>::remove(const T& value) {
-    return map.remove(value);
+template<typename T, typename Hash, typename KeyEqual>
+size_t Set<T, Hash, KeyEqual>::bucketCount() const {
+    return table.bucketCount();
 }
 
-template<typename T>
-void Set<T>::clear() {
-    map.clear();
+template<typename T, typename Hash, typename KeyEqual>
+void Set<T, Hash, KeyEqual>::reserve(size_t n) {
+    table.reserve(n);
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+size_t Set<T, Hash, KeyEqual>::memoryUsage() const {
+    return table.memoryUsage();
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+template<typename F>
+void Set<T, Hash, KeyEqual>::forEach(F f) const {
+    for (size_t i = 0; i < table.bucketCount(); i++) {
+        if (table.occupied(i)) {
+            f(table.slotAt(i));
+        }
+    }
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+void Set<T, Hash, KeyEqual>::print(std::ostream& os) const {
+    os << "Set {";
+    bool first = true;
+    forEach([&os, &first](const T& value) {
+        os << (first ? " " : ", ") << value;
+        first = false;
+    });
+    os << " } (size: " << table.size() << ")";
+}
+
+template<typename T, typename Hash, typename KeyEqual>
+template<typename Pred>
+std::vector<T> Set<T, Hash, KeyEqual>::collect(Pred keep, size_t threads) const {
+    if (threads == 0) {
+        threads = table.size() < PARALLEL_THRESHOLD ? 1 : std::thread::hardware_concurrency();
+    }
+    size_t groups = table.groupCount();
+    threads = std::max<size_t>(1, std::min(threads, groups));
+
+    // Каждый поток просматривает свой диапазон групп и копит найденное
+    // у себя; таблица только читается, синхронизация не нужна
+    std::vector<std::vector<T>> parts(threads);
+    auto scan = [this, &keep, &parts, groups, threads](size_t part) {
+        size_t from = groups * part / threads * ControlGroup::WIDTH;
+        size_t to = groups * (part + 1) / threads * ControlGroup::WIDTH;
+        for (size_t i = from; i < to; i++) {
+            if (table.occupied(i) && keep(table.slotAt(i))) {
+                parts[part].push_back(table.slotAt(i));
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t part = 1; part < threads; part++) {
+        workers.emplace_back(scan, part);
+    }
+    scan(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    std::vector<T> result;
+    result.reserve(total);
+    for (auto& part : parts) {
+        std::move(part.begin(), part.end(), std::back_inserter(result));
+    }
+    return result;
 }
 
-template<typename T>
-size_t Set<T>::size() const {
-    return map.size();
+template<typename T, typename Hash, typename KeyEqual>
+Set<T, Hash, KeyEqual> Set<T, Hash, KeyEqual>::unionOf(const Set& a, const Set& b, size_t threads) {
+    // Копируется большее множество, из меньшего добавляется недостающее
+    const Set& larger = a.size() >= b.size() ? a : b;
+    const Set& smaller = a.size() >= b.size() ? b : a;
+    std::vector<T> extra = smaller.collect(
+        [&larger](const T& value) { return !larger.contains(value); }, threads);
+    Set result(larger);
+    result.reserve(larger.size() + extra.size());
+    for (const T& value : extra) {
+        result.add(value);
+    }
+    return result;
 }
 
-template<typename T>
-bool Set<T>::empty() const {
-    return map.empty();
+template<typename T, typename Hash, typename KeyEqual>
+Set<T, Hash, KeyEqual> Set<T, Hash, KeyEqual>::intersectionOf(const Set& a, const Set& b, size_t threads) {
+    const Set& larger = a.size() >= b.size() ? a : b;
+    const Set& smaller = a.size() >= b.size() ? b : a;
+    std::vector<T> common = smaller.collect(
+        [&larger](const T& value) { return larger.contains(value); }, threads);
+    Set result(common.size());
+    for (const T& value : common) {
+        result.add(value);
+    }
+    return result;
 }
 
-template<typename T>
-void Set<T>::print(std::ostream& os) const {
-    os << "Set { size: " << size() << " }";
+template<typename T, typename Hash, typename KeyEqual>
+Set<T, Hash, KeyEqual> Set<T, Hash, KeyEqual>::differenceOf(const Set& a, const Set& b, size_t threads) {
+    std::vector<T> rest = a.collect(
+        [&b](const T& value) { return !b.contains(value); }, threads);
+    Set result(rest.size());
+    for (const T& value : rest) {
+        result.add(value);
+    }
+    return result;
 }
 
 #endif
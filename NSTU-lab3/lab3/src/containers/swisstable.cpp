@@ -0,0 +1,333 @@
+#ifndef SWISSTABLE_CPP
+#define SWISSTABLE_CPP
+
+#include <cstdint>
+#include <algorithm>
+#include "hash.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Реализация ControlGroup
+
+#ifdef __SSE2__
+
+inline uint32_t ControlGroup::match(const int8_t* group, int8_t h2) {
+    __m128i ctrlBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrlBytes)));
+}
+
+inline uint32_t ControlGroup::matchEmpty(const int8_t* group) {
+    return match(group, EMPTY);
+}
+
+inline uint32_t ControlGroup::matchEmptyOrDeleted(const int8_t* group) {
+    // EMPTY и DELETED - единственные отрицательные значения: достаточно знаковых бит
+    __m128i ctrlBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<uint32_t>(_mm_movemask_epi8(ctrlBytes));
+}
+
+#else
+
+inline uint32_t ControlGroup::match(const int8_t* group, int8_t h2) {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < WIDTH; i++) {
+        if (group[i] == h2) mask |= 1u << i;
+    }
+    return mask;
+}
+
+inline uint32_t ControlGroup::matchEmpty(const int8_t* group) {
+    return match(group, EMPTY);
+}
+
+inline uint32_t ControlGroup::matchEmptyOrDeleted(const int8_t* group) {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < WIDTH; i++) {
+        if (group[i] < 0) mask |= 1u << i;
+    }
+    return mask;
+}
+
+#endif
+
+inline size_t ControlGroup::lowestBit(uint32_t mask) {
+    return static_cast<size_t>(__builtin_ctz(mask));
+}
+
+// Реализация ControlTable
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+ControlTable<Slot, KeyOf, Hash, KeyEqual>::ControlTable(size_t initialCapacity)
+    : groupMask(0), count(0), tombstones(0) {
+    resize(groupsFor(initialCapacity));
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+size_t ControlTable<Slot, KeyOf, Hash, KeyEqual>::groupsFor(size_t n) {
+    // Максимальная заполненность - 7/8 слотов
+    size_t slotsNeeded = n + n / 7 + 1;
+    size_t groups = 1;
+    while (groups * ControlGroup::WIDTH < slotsNeeded) {
+        groups *= 2;
+    }
+    return groups;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+template<typename Q>
+size_t ControlTable<Slot, KeyOf, Hash, KeyEqual>::hashOf(const Q& key) const {
+    // std::hash<int> - тождество; перемешиваем, чтобы и H2 (младшие 7 бит),
+    // и номер группы (остальные) зависели от всех бит ключа
+    return static_cast<size_t>(mixHash64(static_cast<uint64_t>(hasher(key))));
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+size_t ControlTable<Slot, KeyOf, Hash, KeyEqual>::growthLimit() const {
+    size_t capacity = ctrl.size();
+    return capacity - capacity / 8;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+template<typename Q>
+bool ControlTable<Slot, KeyOf, Hash, KeyEqual>::findSlot(const Q& key, size_t hash, size_t& index) const {
+    int8_t h2 = static_cast<int8_t>(hash & 0x7F);
+    size_t group = (hash >> 7) & groupMask;
+
+    // Треугольная последовательность групп обходит все группы,
+    // так как их число - степень двойки
+    for (size_t step = 1; step <= groupMask + 1; step++) {
+        const int8_t* groupCtrl = &ctrl[group * ControlGroup::WIDTH];
+        uint32_t candidates = ControlGroup::match(groupCtrl, h2);
+        while (candidates) {
+            size_t i = group * ControlGroup::WIDTH + ControlGroup::lowestBit(candidates);
+            if (keyEqual(keyOf(slots[i]), key)) {
+                index = i;
+                return true;
+            }
+            candidates &= candidates - 1;
+        }
+        // Группа с пустым слотом завершает цепочку
+        if (ControlGroup::matchEmpty(groupCtrl)) {
+            return false;
+        }
+        group = (group + step) & groupMask;
+    }
+    return false;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+size_t ControlTable<Slot, KeyOf, Hash, KeyEqual>::findInsertSlot(size_t hash) const {
+    size_t group = (hash >> 7) & groupMask;
+    for (size_t step = 1; ; step++) {
+        uint32_t free = ControlGroup::matchEmptyOrDeleted(&ctrl[group * ControlGroup::WIDTH]);
+        if (free) {
+            return group * ControlGroup::WIDTH + ControlGroup::lowestBit(free);
+        }
+        group = (group + step) & groupMask;
+    }
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+void ControlTable<Slot, KeyOf, Hash, KeyEqual>::resize(size_t groups) {
+    std::vector<int8_t> oldCtrl(groups * ControlGroup::WIDTH, ControlGroup::EMPTY);
+    std::vector<Slot> oldSlots(groups * ControlGroup::WIDTH);
+    oldCtrl.swap(ctrl);
+    oldSlots.swap(slots);
+    groupMask = groups - 1;
+    tombstones = 0;
+
+    for (size_t i = 0; i < oldCtrl.size(); i++) {
+        if (oldCtrl[i] >= 0) {
+            size_t hash = hashOf(keyOf(oldSlots[i]));
+            size_t target = findInsertSlot(hash);
+            ctrl[target] = static_cast<int8_t>(hash & 0x7F);
+            slots[target] = std::move(oldSlots[i]);
+        }
+    }
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+template<typename Q>
+const Slot* ControlTable<Slot, KeyOf, Hash, KeyEqual>::find(const Q& key) const {
+    size_t index;
+    return findSlot(key, hashOf(key), index) ? &slots[index] : nullptr;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+template<typename Q>
+Slot* ControlTable<Slot, KeyOf, Hash, KeyEqual>::find(const Q& key) {
+    size_t index;
+    return findSlot(key, hashOf(key), index) ? &slots[index] : nullptr;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+template<typename Q>
+std::pair<Slot*, bool> ControlTable<Slot, KeyOf, Hash, KeyEqual>::insert(const Q& key) {
+    size_t hash = hashOf(key);
+    size_t index;
+    if (findSlot(key, hash, index)) {
+        return {&slots[index], false};
+    }
+
+    if (count + tombstones + 1 > growthLimit()) {
+        // Если место заняли надгробия, достаточно перестроить таблицу того же размера
+        bool mostlyTombstones = tombstones > count / 2;
+        resize(mostlyTombstones ? groupMask + 1 : (groupMask + 1) * 2);
+    }
+
+    index = findInsertSlot(hash);
+    if (ctrl[index] == ControlGroup::DELETED) {
+        tombstones--;
+    }
+    ctrl[index] = static_cast<int8_t>(hash & 0x7F);
+    count++;
+    return {&slots[index], true};
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+template<typename Q>
+bool ControlTable<Slot, KeyOf, Hash, KeyEqual>::erase(const Q& key) {
+    size_t index;
+    if (!findSlot(key, hashOf(key), index)) {
+        return false;
+    }
+    // Если в группе уже есть пустой слот, ни одна цепочка не проходит
+    // через неё дальше - слот можно сразу пометить пустым
+    const int8_t* groupCtrl = &ctrl[index - index % ControlGroup::WIDTH];
+    if (ControlGroup::matchEmpty(groupCtrl)) {
+        ctrl[index] = ControlGroup::EMPTY;
+    } else {
+        ctrl[index] = ControlGroup::DELETED;
+        tombstones++;
+    }
+    slots[index] = Slot();
+    count--;
+    return true;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+void ControlTable<Slot, KeyOf, Hash, KeyEqual>::clear() {
+    std::fill(ctrl.begin(), ctrl.end(), ControlGroup::EMPTY);
+    std::fill(slots.begin(), slots.end(), Slot());
+    count = 0;
+    tombstones = 0;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+size_t ControlTable<Slot, KeyOf, Hash, KeyEqual>::size() const {
+    return count;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+size_t ControlTable<Slot, KeyOf, Hash, KeyEqual>::bucketCount() const {
+    return ctrl.size();
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+void ControlTable<Slot, KeyOf, Hash, KeyEqual>::reserve(size_t n) {
+    size_t groups = groupsFor(n);
+    if (groups > groupMask + 1) {
+        resize(groups);
+    }
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+size_t ControlTable<Slot, KeyOf, Hash, KeyEqual>::memoryUsage() const {
+    return ctrl.capacity() + slots.capacity() * sizeof(Slot);
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+bool ControlTable<Slot, KeyOf, Hash, KeyEqual>::occupied(size_t index) const {
+    return ctrl[index] >= 0;
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+const Slot& ControlTable<Slot, KeyOf, Hash, KeyEqual>::slotAt(size_t index) const {
+    return slots[index];
+}
+
+template<typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+size_t ControlTable<Slot, KeyOf, Hash, KeyEqual>::groupCount() const {
+    return groupMask + 1;
+}
+
+// Реализация SwissHashMap
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+SwissHashMap<K, V, Hash, KeyEqual>::SwissHashMap(size_t initialCapacity)
+    : table(initialCapacity) {}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void SwissHashMap<K, V, Hash, KeyEqual>::put(const K& key, const V& value) {
+    auto [slot, inserted] = table.insert(key);
+    if (inserted) {
+        slot->key = key;
+    }
+    slot->value = value;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+V SwissHashMap<K, V, Hash, KeyEqual>::get(const K& key) const {
+    const Slot* slot = table.find(key);
+    if (slot) {
+        return slot->value;
+    }
+    throw std::runtime_error("Ключ не найден");
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool SwissHashMap<K, V, Hash, KeyEqual>::contains(const K& key) const {
+    return table.find(key) != nullptr;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+template<typename Q, typename>
+bool SwissHashMap<K, V, Hash, KeyEqual>::contains(const Q& key) const {
+    return table.find(key) != nullptr;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool SwissHashMap<K, V, Hash, KeyEqual>::remove(const K& key) {
+    return table.erase(key);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void SwissHashMap<K, V, Hash, KeyEqual>::clear() {
+    table.clear();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t SwissHashMap<K, V, Hash, KeyEqual>::size() const {
+    return table.size();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+bool SwissHashMap<K, V, Hash, KeyEqual>::empty() const {
+    return table.size() == 0;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+size_t SwissHashMap<K, V, Hash, KeyEqual>::bucketCount() const {
+    return table.bucketCount();
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void SwissHashMap<K, V, Hash, KeyEqual>::reserve(size_t n) {
+    table.reserve(n);
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void SwissHashMap<K, V, Hash, KeyEqual>::print(std::ostream& os) const {
+    os << "SwissHashMap {\n";
+    for (size_t i = 0; i < table.bucketCount(); i++) {
+        if (table.occupied(i)) {
+            os << "  [" << i << "] " << table.slotAt(i).key
+               << " => " << table.slotAt(i).value << "\n";
+        }
+    }
+    os << "} (size: " << table.size() << ")";
+}
+
+#endif
@@ -6,41 +6,163 @@
 #include <algorithm>
 #include <stdexcept>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Пул узлов: узлы берутся из больших непрерывных блоков (слэбов),
+// освобождённые ячейки уходят в список свободных и переиспользуются.
+// release() отдаёт всю память разом, не вызывая деструкторов
+template<typename NodeT>
+class NodePool {
+private:
+    union Slot {
+        Slot* next;
+        alignas(NodeT) unsigned char storage[sizeof(NodeT)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot* cursor;
+    Slot* slabEnd;
+    Slot* freeList;
+    size_t slotCount;
+
+    Slot* allocateSlot();
+
+public:
+    // Слэбы растут вдвое от первого до последнего размера: маленькое
+    // дерево не держит лишнего, большое не плодит тысячи слэбов
+    static constexpr size_t FIRST_SLAB = 32;
+    static constexpr size_t MAX_SLAB = 1 << 16;
+
+    NodePool();
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    NodePool(NodePool&& other) noexcept;
+    NodePool& operator=(NodePool&& other) noexcept;
+
+    template<typename... Args>
+    NodeT* create(Args&&... args);
+    void destroy(NodeT* node);
+    void release();
+    size_t capacity() const;
+    size_t memoryUsage() const;
+};
+
+// Агрегаты поддеревьев для AVLTree. Политика задаёт тип value_type,
+// нейтральный элемент identity(), значение узла of(x) и ассоциативное
+// combine(a, b), где a - левее b (коммутативность не требуется)
+struct NoAggregate {
+    using value_type = void;
+};
 
 template<typename T>
+struct SumAggregate {
+    using value_type = T;
+    static T identity() { return T(); }
+    static T of(const T& value) { return value; }
+    static T combine(const T& a, const T& b) { return a + b; }
+};
+
+// Поле агрегата в узле; без агрегата - пустая база, узел не растёт
+template<typename Aggregate>
+struct AggregateField {
+    typename Aggregate::value_type aggregate;
+};
+
+template<>
+struct AggregateField<NoAggregate> {};
+
+template<typename T, typename Aggregate = NoAggregate>
 class AVLTree : public Container<T> {
 private:
-    struct Node {
+    static constexpr bool HAS_AGGREGATE = !std::is_same<Aggregate, NoAggregate>::value;
+
+    struct Node : AggregateField<Aggregate> {
         T data;
         int height;
+        // Число узлов в поддереве - для ранга и выбора по номеру
+        size_t size;
         Node* left;
         Node* right;
+        // Родитель - для шага итератора без стека
+        Node* parent;
         Node(const T& value);
+        Node(T&& value);
     };
     
+    // Высота AVL-дерева из n узлов меньше 1.44 * log2(n + 2): при n < 2^64
+    // это меньше 93. Пути и стеки обходов - массивы такой длины на стеке
+    static constexpr int MAX_HEIGHT = 96;
+
     Node* root;
     size_t count;
+    NodePool<Node> pool;
     
     int getHeight(Node* node) const;
     int getBalance(Node* node) const;
-    void updateHeight(Node* node);
+    size_t getSize(Node* node) const;
+    // Пересчёт высоты, размера и агрегата узла по детям
+    void updateNode(Node* node);
     Node* rotateRight(Node* y);
     Node* rotateLeft(Node* x);
     Node* rebalance(Node* node);
-    Node* insertNode(Node* node, const T& value);
-    Node* findMin(Node* node) const;
-    Node* deleteNode(Node* node, const T& value);
-    bool searchNode(Node* node, const T& value) const;
+    // Подъём от места вставки (grew) или удаления: links - указатели
+    // на ссылки предков, сверху вниз
+    void retrace(Node** links[], int depth, bool grew);
+    bool insertNode(const T& value);
+    bool deleteNode(const T& value);
+    template<typename Q>
+    bool searchNode(const Q& value) const;
     void clearNode(Node* node);
+    // Идеально сбалансированное дерево из строго возрастающих values за O(n)
+    void buildBalanced(std::vector<T>& values);
     void inorderTraversal(Node* node, std::ostream& os) const;
+    static Node* leftmost(Node* node);
+    static Node* rightmost(Node* node);
+    // Соседи в порядке возрастания, nullptr за краем дерева
+    static Node* successor(Node* node);
+    static Node* predecessor(Node* node);
 
 public:
+    // Двунаправленный итератор по возрастанию. Значения не изменяются
+    // через итератор - на них держится порядок. insert итераторы не
+    // портит, remove портит
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() : tree(nullptr), node(nullptr) {}
+        reference operator*() const { return node->data; }
+        pointer operator->() const { return &node->data; }
+        const_iterator& operator++() { node = successor(node); return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        // Шаг назад от end() - к наибольшему элементу
+        const_iterator& operator--() { node = node ? predecessor(node) : rightmost(tree->root); return *this; }
+        const_iterator operator--(int) { const_iterator old = *this; --*this; return old; }
+        bool operator==(const const_iterator& other) const { return node == other.node; }
+        bool operator!=(const const_iterator& other) const { return node != other.node; }
+
+    private:
+        friend class AVLTree;
+        const_iterator(const AVLTree* owner, Node* at) : tree(owner), node(at) {}
+        const AVLTree* tree;
+        Node* node;
+    };
+    using iterator = const_iterator;
+
     AVLTree();
     ~AVLTree() override;
     AVLTree(const AVLTree&) = delete;
     AVLTree& operator=(const AVLTree&) = delete;
     
-    AVLTree(AVLTree&& other) noexcept : root(other.root), count(other.count) {
+    AVLTree(AVLTree&& other) noexcept
+        : root(other.root), count(other.count), pool(std::move(other.pool)) {
         other.root = nullptr;
         other.count = 0;
     }
@@ -50,6 +172,7 @@ public:
             clear();
             root = other.root;
             count = other.count;
+            pool = std::move(other.pool);
             other.root = nullptr;
             other.count = 0;
         }
@@ -57,12 +180,44 @@ public:
     }
     
     void insert(const T& value);
+    // Замена содержимого: уже возрастающие values строятся в дерево за
+    // O(n) без поворотов, прочие сначала сортируются. Повторы отбрасываются
+    void bulkLoad(std::vector<T> values);
     void remove(const T& value);
     bool search(const T& value) const;
+    // Поиск по значению, сравнимому с T без преобразования
+    // (например, std::string_view для AVLTree<std::string>)
+    template<typename Q>
+    bool search(const Q& value) const;
     void clear() override;
     size_t size() const override;
     bool empty() const override;
     int height() const;
+    
+    // Порядковая статистика за O(log n)
+    // Число элементов меньше value
+    template<typename Q>
+    size_t rank(const Q& value) const;
+    // k-й по возрастанию элемент, с нуля
+    const T& select(size_t k) const;
+    // Число элементов в отрезке [lo, hi]
+    template<typename Q>
+    size_t countRange(const Q& lo, const Q& hi) const;
+    // Агрегат элементов отрезка [lo, hi] (только с политикой агрегата)
+    template<typename Q>
+    typename Aggregate::value_type aggregateRange(const Q& lo, const Q& hi) const;
+    
+    // Обход по возрастанию; шаг - O(1) в среднем, O(log n) в худшем
+    const_iterator begin() const;
+    const_iterator end() const;
+    // Первый элемент не меньше value / больше value
+    template<typename Q>
+    const_iterator lower_bound(const Q& value) const;
+    template<typename Q>
+    const_iterator upper_bound(const Q& value) const;
+    
+    // Память под узлы: все слэбы пула, включая свободные ячейки
+    size_t memoryUsage() const;
     void print(std::ostream& os = std::cout) const;
     void saveToFile(const std::string& filename) const;
     void loadFromFile(const std::string& filename);
@@ -72,9 +227,13 @@ public:
     void loadFromBinary(std::ifstream& in);
 private:
     void saveBinaryNode(std::ofstream& out, Node* node) const;
-    Node* loadBinaryNode(std::ifstream& in);
+    void loadBinaryNode(std::ifstream& in, size_t& loaded);
+    // Пересчёт высот и размеров после загрузки; бросает исключение,
+    // если форма из файла - не AVL-дерево
+    void restoreHeights();
 };
 
+#include "nodepool.cpp"
 #include "avl.cpp"
 
 #endif
@@ -0,0 +1,69 @@
+// Бенчмарк построения AVLTree из отсортированных значений: вставка по
+// одной против bulkLoad. Целые - 20M ключей (число - первым аргументом),
+// строки - в десять раз меньше. После построения - случайный поиск,
+// чтобы видеть и раскладку узлов в памяти
+#include "../src/containers/trees.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename T>
+double searchNanoseconds(const AVLTree<T>& tree, const std::vector<T>& probes) {
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const T& key : probes) found += tree.search(key);
+    double seconds = secondsSince(start);
+    if (found != probes.size()) std::printf("!");
+    return seconds * 1e9 / static_cast<double>(probes.size());
+}
+
+template<typename T>
+void compare(const char* name, const std::vector<T>& sorted) {
+    std::vector<T> probes(sorted.begin(), sorted.begin() + std::min<size_t>(sorted.size(), 1000000));
+    std::shuffle(probes.begin(), probes.end(), std::mt19937(3));
+    std::printf("%s: %zu ключей\n", name, sorted.size());
+
+    {
+        AVLTree<T> tree;
+        auto start = std::chrono::steady_clock::now();
+        for (const T& value : sorted) tree.insert(value);
+        double build = secondsSince(start);
+        std::printf("  %-10s %10.0f мс  высота %3d  поиск %6.1f нс\n", "insert", build * 1e3,
+                    tree.height(), searchNanoseconds(tree, probes));
+    }
+    {
+        AVLTree<T> tree;
+        std::vector<T> copy = sorted;
+        auto start = std::chrono::steady_clock::now();
+        tree.bulkLoad(std::move(copy));
+        double build = secondsSince(start);
+        std::printf("  %-10s %10.0f мс  высота %3d  поиск %6.1f нс\n", "bulkLoad", build * 1e3,
+                    tree.height(), searchNanoseconds(tree, probes));
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+
+    std::vector<long long> numbers(keys);
+    for (size_t i = 0; i < keys; i++) numbers[i] = static_cast<long long>(i) * 3;
+    compare("Целые", numbers);
+    numbers = std::vector<long long>();
+
+    std::vector<std::string> words;
+    for (size_t i = 0; i < keys / 10; i++) words.push_back("key:" + std::to_string(1000000000 + i));
+    compare("Строки", words);
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Бенчмарк пула узлов AVLTree: вставка, поиск и очистка на дереве
+// из 10M узлов (размер - первым аргументом). Для сравнения - std::set,
+// где каждый узел берётся из кучи отдельно, как было в AVLTree до пула.
+// Промахи кэша при поиске читаются через perf_event_open, если ядро
+// разрешает; иначе печатается только время
+#include "../src/containers/trees.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+class CacheMissCounter {
+private:
+    int fd;
+
+public:
+    CacheMissCounter() : fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    long long stop() {
+        long long misses = 0;
+#ifdef __linux__
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &misses, sizeof(misses)) != static_cast<ssize_t>(sizeof(misses))) misses = 0;
+#endif
+        return misses;
+    }
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Tree, typename Insert, typename Contains>
+void measure(const char* name, const std::vector<int>& keys, const std::vector<int>& probes,
+             Insert insert, Contains contains) {
+    CacheMissCounter counter;
+    auto* tree = new Tree();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int key : keys) insert(*tree, key);
+    double insertSeconds = secondsSince(start);
+
+    size_t found = 0;
+    counter.start();
+    start = std::chrono::steady_clock::now();
+    for (int key : probes) found += contains(*tree, key);
+    double searchSeconds = secondsSince(start);
+    long long misses = counter.stop();
+
+    start = std::chrono::steady_clock::now();
+    delete tree;
+    double clearSeconds = secondsSince(start);
+
+    double n = static_cast<double>(keys.size());
+    std::printf("  %-10s %12.2f %12.1f", name, n / insertSeconds / 1e6,
+                searchSeconds * 1e9 / static_cast<double>(probes.size()));
+    if (counter.available()) {
+        std::printf(" %14.2f", static_cast<double>(misses) / static_cast<double>(probes.size()));
+    } else {
+        std::printf(" %14s", "н/д");
+    }
+    std::printf(" %12.1f   (найдено %zu)\n", clearSeconds * 1e3, found);
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t nodes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::vector<int> keys(nodes);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::mt19937 rng(7);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<int> probes(keys.begin(), keys.begin() + std::min<size_t>(nodes, 2000000));
+    std::shuffle(probes.begin(), probes.end(), rng);
+
+    std::printf("Узлов: %zu, поисков: %zu\n", nodes, probes.size());
+    std::printf("  %-10s %12s %12s %14s %12s\n", "", "вставка M/с", "поиск нс", "промахов/поиск", "очистка мс");
+    measure<AVLTree<int>>("AVL+пул", keys, probes,
+        [](AVLTree<int>& t, int k) { t.insert(k); },
+        [](const AVLTree<int>& t, int k) { return t.search(k); });
+    measure<std::set<int>>("std::set", keys, probes,
+        [](std::set<int>& t, int k) { t.insert(k); },
+        [](const std::set<int>& t, int k) { return t.count(k) != 0; });
+    return 0;
+}
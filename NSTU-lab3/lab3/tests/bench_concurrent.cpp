@@ -0,0 +1,83 @@
+// Бенчмарк ConcurrentHashMap: пропускная способность на смеси
+// 90% чтений / 10% записей при числе потоков от 1 до числа ядер.
+// Для сравнения - обычный HashMap под одним мьютексом
+#include "../src/containers/hash.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int KEY_SPACE = 1 << 20;
+const int OPS_PER_THREAD = 1000000;
+
+// Обёртка с одной блокировкой на всю таблицу
+class LockedHashMap {
+public:
+    void put(int key, int value) {
+        std::lock_guard<std::mutex> guard(lock);
+        map.put(key, value);
+    }
+    bool contains(int key) {
+        std::lock_guard<std::mutex> guard(lock);
+        return map.contains(key);
+    }
+private:
+    std::mutex lock;
+    HashMap<int, int> map;
+};
+
+template<typename Map>
+double run(Map& map, int threads) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&map, t]() {
+            std::mt19937 rng(t + 1);
+            long found = 0;
+            for (int i = 0; i < OPS_PER_THREAD; i++) {
+                int key = static_cast<int>(rng() % KEY_SPACE);
+                if (rng() % 10 == 0) {
+                    map.put(key, i);
+                } else {
+                    found += map.contains(key);
+                }
+            }
+            if (found < 0) std::printf("%ld", found);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * static_cast<double>(OPS_PER_THREAD) / elapsed.count() / 1e6;
+}
+
+template<typename Map>
+void prefill(Map& map) {
+    for (int key = 0; key < KEY_SPACE; key += 2) {
+        map.put(key, key);
+    }
+}
+
+} // namespace
+
+int main() {
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::printf("Смесь 90/10 чтение/запись, %d ключей, %d операций на поток\n", KEY_SPACE, OPS_PER_THREAD);
+    std::printf("%8s %22s %22s\n", "потоки", "ConcurrentHashMap Mops", "HashMap+mutex Mops");
+    
+    for (int threads = 1; ; threads *= 2) {
+        threads = std::min(threads, cores);
+        ConcurrentHashMap<int, int> sharded(64, KEY_SPACE);
+        LockedHashMap locked;
+        prefill(sharded);
+        prefill(locked);
+        std::printf("%8d %22.2f %22.2f\n", threads, run(sharded, threads), run(locked, threads));
+        if (threads == cores) break;
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Бенчмарк ConcurrentCuckooHashMap: пропускная способность на смеси
+// 99% чтений / 1% записей при числе потоков от 1 до числа ядер.
+// Для сравнения - ConcurrentHashMap (чтения под shared_mutex сегмента)
+// и ReadMostlyHashMap (чтения без блокировок, копирование при записи)
+#include "../src/containers/hash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int KEY_SPACE = 1 << 20;
+const int OPS_PER_THREAD = 2000000;
+
+template<typename Map>
+double run(Map& map, int threads) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&map, t]() {
+            std::mt19937 rng(t + 1);
+            long found = 0;
+            for (int i = 0; i < OPS_PER_THREAD; i++) {
+                int key = static_cast<int>(rng() % KEY_SPACE);
+                if (rng() % 100 == 0) {
+                    map.put(key, i);
+                } else {
+                    found += map.contains(key);
+                }
+            }
+            if (found < 0) std::printf("%ld", found);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * static_cast<double>(OPS_PER_THREAD) / elapsed.count() / 1e6;
+}
+
+template<typename Map>
+void prefill(Map& map) {
+    for (int key = 0; key < KEY_SPACE; key += 2) {
+        map.put(key, key);
+    }
+}
+
+} // namespace
+
+int main() {
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::printf("Смесь 99/1 чтение/запись, %d ключей, %d операций на поток\n", KEY_SPACE, OPS_PER_THREAD);
+    std::printf("%8s %16s %16s %16s\n", "потоки", "Cuckoo Mops", "Sharded Mops", "ReadMostly Mops");
+
+    for (int threads = 1; ; threads *= 2) {
+        threads = std::min(threads, cores);
+        ConcurrentCuckooHashMap<int, int> cuckoo(KEY_SPACE);
+        ConcurrentHashMap<int, int> sharded(64, KEY_SPACE);
+        ReadMostlyHashMap<int, int> readMostly(KEY_SPACE);
+        prefill(cuckoo);
+        prefill(sharded);
+        prefill(readMostly);
+        std::printf("%8d %16.2f %16.2f %16.2f\n", threads,
+                    run(cuckoo, threads), run(sharded, threads), run(readMostly, threads));
+        if (threads == cores) break;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Бенчмарк кукушкиного хеширования: заполненность двух таблиц
+// в момент первой неудачной вставки (цепочка вытеснений длиннее
+// MAX_KICKS) для разных способов получить две позиции ключа.
+// Для независимых хешей теория даёт около 50%
+#include "../src/containers/hash.h"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const size_t CAPACITY = 1 << 14;
+const int MAX_KICKS = 100;
+const int TRIALS = 10;
+
+using Positions = std::pair<size_t, size_t>;
+
+// Вставляет ключи keyOf(0), keyOf(1), ... до первого цикла,
+// возвращает долю занятых слотов
+template<typename K, typename KeyOf, typename PositionsOf>
+double loadAtFirstFailure(KeyOf keyOf, PositionsOf positionsOf) {
+    std::vector<K> table1(CAPACITY), table2(CAPACITY);
+    std::vector<bool> used1(CAPACITY), used2(CAPACITY);
+    size_t count = 0;
+    while (count < 2 * CAPACITY) {
+        K key = keyOf(count);
+        bool toFirst = true;
+        int kick = 0;
+        for (; kick < MAX_KICKS; kick++) {
+            Positions p = positionsOf(key);
+            std::vector<K>& table = toFirst ? table1 : table2;
+            std::vector<bool>& used = toFirst ? used1 : used2;
+            size_t index = toFirst ? p.first : p.second;
+            if (!used[index]) {
+                used[index] = true;
+                table[index] = std::move(key);
+                break;
+            }
+            std::swap(table[index], key);
+            toFirst = !toFirst;
+        }
+        if (kick == MAX_KICKS) {
+            break;
+        }
+        count++;
+    }
+    return static_cast<double>(count) / static_cast<double>(2 * CAPACITY);
+}
+
+// Три схемы позиций для одного набора ключей; trial меняет ключи
+template<typename K, typename KeyOf>
+void report(const char* keys, KeyOf keyOf) {
+    std::hash<K> stdHash;
+    SeededHash<K> seeded;
+    const char* names[] = {"h % n, h / n % n", "mix(h ^ seed1), mix(h ^ seed2)", "wyHash128(key, seed)"};
+    for (int scheme = 0; scheme < 3; scheme++) {
+        double total = 0.0, worst = 1.0;
+        for (int trial = 0; trial < TRIALS; trial++) {
+            uint64_t seed = mixHash64(static_cast<uint64_t>(trial));
+            auto positionsOf = [&](const K& key) {
+                if (scheme == 2) {
+                    Hash128 h = seeded(key, seed);
+                    return Positions{h.first % CAPACITY, h.second % CAPACITY};
+                }
+                uint64_t h = static_cast<uint64_t>(stdHash(key));
+                if (scheme == 0) {
+                    return Positions{h % CAPACITY, h / CAPACITY % CAPACITY};
+                }
+                return Positions{mixHash64(h ^ seed) % CAPACITY, mixHash64(h ^ ~seed) % CAPACITY};
+            };
+            auto trialKeyOf = [&](size_t i) { return keyOf(i, trial); };
+            double load = loadAtFirstFailure<K>(trialKeyOf, positionsOf);
+            total += load;
+            worst = std::min(worst, load);
+        }
+        std::printf("%-22s %-32s %8.3f %8.3f\n", keys, names[scheme], total / TRIALS, worst);
+    }
+}
+
+}
+
+int main() {
+    std::printf("Ёмкость: 2 x %zu слотов, попыток: %d\n", CAPACITY, TRIALS);
+    std::printf("%-22s %-32s %8s %8s\n", "ключи", "позиции", "средняя", "худшая");
+
+    report<uint64_t>("последовательные", [](size_t i, int trial) {
+        return static_cast<uint64_t>(trial) * CAPACITY * CAPACITY + i;
+    });
+    // Для тождественного std::hash у всех ключей одна первая позиция
+    report<uint64_t>("с шагом n", [](size_t i, int trial) {
+        return (static_cast<uint64_t>(i) + 1) * CAPACITY + static_cast<uint64_t>(trial);
+    });
+    report<std::string>("строки user:<i>", [](size_t i, int trial) {
+        return "user:" + std::to_string(trial) + ":" + std::to_string(i);
+    });
+    return 0;
+}
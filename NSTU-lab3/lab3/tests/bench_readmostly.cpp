@@ -0,0 +1,74 @@
+// Бенчмарк ReadMostlyHashMap: суммарная скорость чтения при числе
+// потоков-читателей от 1 до числа ядер, пока один писатель непрерывно
+// обновляет значения. Для сравнения - ConcurrentHashMap под тем же потоком
+#include "../src/containers/hash.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int KEY_SPACE = 1 << 16;
+const int READS_PER_THREAD = 2000000;
+
+template<typename Map>
+double run(Map& map, int readers) {
+    std::atomic<bool> stop{false};
+    std::thread writer([&map, &stop]() {
+        std::mt19937 rng(42);
+        int value = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            map.put(static_cast<int>(rng() % KEY_SPACE), value++);
+        }
+    });
+    
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < readers; t++) {
+        workers.emplace_back([&map, t]() {
+            std::mt19937 rng(t + 1);
+            long found = 0;
+            for (int i = 0; i < READS_PER_THREAD; i++) {
+                found += map.contains(static_cast<int>(rng() % KEY_SPACE));
+            }
+            if (found < 0) std::printf("%ld", found);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    stop.store(true);
+    writer.join();
+    return readers * static_cast<double>(READS_PER_THREAD) / elapsed.count() / 1e6;
+}
+
+template<typename Map>
+void prefill(Map& map) {
+    for (int key = 0; key < KEY_SPACE; key++) {
+        map.put(key, key);
+    }
+}
+
+} // namespace
+
+int main() {
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::printf("Чтения при одном активном писателе, %d ключей, %d чтений на поток\n",
+                KEY_SPACE, READS_PER_THREAD);
+    std::printf("%10s %24s %24s\n", "читатели", "ReadMostlyHashMap Mops", "ConcurrentHashMap Mops");
+    
+    for (int readers = 1; ; readers *= 2) {
+        readers = std::min(readers, cores);
+        ReadMostlyHashMap<int, int> readMostly(KEY_SPACE);
+        ConcurrentHashMap<int, int> sharded(64, KEY_SPACE);
+        prefill(readMostly);
+        prefill(sharded);
+        std::printf("%10d %24.2f %24.2f\n", readers, run(readMostly, readers), run(sharded, readers));
+        if (readers == cores) break;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Бенчмарк RoaringSet против Set<uint32_t>: память и время алгебры
+// на трёх видах множеств идентификаторов - плотные отрезки (блоки
+// из отрезков), каждый второй id (битовые карты) и редкие случайные
+// id (массивы). Отрезки и чётные id двух множеств перекрываются наполовину
+#include "../src/containers/hash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint32_t IDS = 1000000;
+const int REPEATS = 5;
+
+template<typename SetType, typename Op>
+double millisecondsOf(const SetType& a, const SetType& b, Op op) {
+    double best = 1e9;
+    for (int r = 0; r < REPEATS; r++) {
+        auto start = std::chrono::steady_clock::now();
+        SetType result = op(a, b);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (result.size() == 0) std::printf("-");
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+template<typename SetType>
+void report(const char* encoding, const SetType& a, const SetType& b) {
+    std::printf("  %-8s %12zu %10.2f %10.2f %10.2f\n", encoding, a.memoryUsage() + b.memoryUsage(),
+                millisecondsOf(a, b, [](const SetType& x, const SetType& y) { return SetType::unionOf(x, y); }),
+                millisecondsOf(a, b, [](const SetType& x, const SetType& y) { return SetType::intersectionOf(x, y); }),
+                millisecondsOf(a, b, [](const SetType& x, const SetType& y) { return SetType::differenceOf(x, y); }));
+}
+
+template<typename IdsOf>
+void compare(const char* name, IdsOf idsOf) {
+    std::vector<uint32_t> first = idsOf(0), second = idsOf(IDS / 2);
+    Set<uint32_t> hashA, hashB;
+    RoaringSet<uint32_t> roaringA, roaringB;
+    for (uint32_t id : first) {
+        hashA.add(id);
+        roaringA.add(id);
+    }
+    for (uint32_t id : second) {
+        hashB.add(id);
+        roaringB.add(id);
+    }
+    roaringA.optimize();
+    roaringB.optimize();
+
+    std::printf("%s: %zu и %zu элементов\n", name, hashA.size(), hashB.size());
+    report("HASH", hashA, hashB);
+    report("ROARING", roaringA, roaringB);
+}
+
+}
+
+int main() {
+    std::printf("  %-8s %12s %10s %10s %10s\n", "", "байт", "union мс", "inter мс", "diff мс");
+    compare("Отрезок id", [](uint32_t offset) {
+        std::vector<uint32_t> ids;
+        for (uint32_t i = 0; i < IDS; i++) ids.push_back(offset + i);
+        return ids;
+    });
+    compare("Каждый второй id", [](uint32_t offset) {
+        std::vector<uint32_t> ids;
+        for (uint32_t i = 0; i < 2 * IDS; i += 2) ids.push_back(offset * 2 + i);
+        return ids;
+    });
+    compare("Редкие случайные id", [](uint32_t offset) {
+        std::mt19937 rng(offset + 1);
+        std::vector<uint32_t> ids;
+        for (uint32_t i = 0; i < IDS / 10; i++) ids.push_back(rng() % (IDS * 100));
+        return ids;
+    });
+    return 0;
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "../src/containers/trees.h"
+#include <cmath>
+#include <random>
+#include <set>
 #include <sstream>
 
 class AVLTreeTest : public ::testing::Test {
@@ -251,3 +254,469 @@ TEST_F(AVLTreeTest, ComplexRotations) {
         EXPECT_TRUE(tree->search(val));
     }
 }
+
+TEST_F(AVLTreeTest, StringViewSearch) {
+    AVLTree<std::string> words;
+    for (const char* word : {"m", "c", "x", "a", "e"}) {
+        words.insert(word);
+    }
+    std::string line = "TSEARCH t e q";
+    EXPECT_TRUE(words.search(std::string_view(line).substr(10, 1)));
+    EXPECT_FALSE(words.search(std::string_view(line).substr(12, 1)));
+    EXPECT_TRUE(words.search("x"));
+}
+
+TEST_F(AVLTreeTest, PoolReusesFreedNodes) {
+    for (int i = 0; i < 1000; i++) {
+        tree->insert(i);
+    }
+    size_t used = tree->memoryUsage();
+    EXPECT_GE(used, 1000 * sizeof(int));
+
+    // Удалённые узлы уходят в список свободных, новые занимают их ячейки
+    for (int i = 0; i < 1000; i += 2) {
+        tree->remove(i);
+    }
+    for (int i = 1000; i < 1500; i++) {
+        tree->insert(i);
+    }
+    EXPECT_EQ(tree->size(), 1000);
+    EXPECT_EQ(tree->memoryUsage(), used);
+    EXPECT_TRUE(tree->search(1499));
+    EXPECT_FALSE(tree->search(998));
+}
+
+TEST_F(AVLTreeTest, ClearReleasesArena) {
+    for (int i = 0; i < 5000; i++) {
+        tree->insert(i);
+    }
+    EXPECT_GT(tree->memoryUsage(), 0u);
+    tree->clear();
+    EXPECT_EQ(tree->memoryUsage(), 0u);
+    EXPECT_TRUE(tree->empty());
+
+    tree->insert(42);
+    EXPECT_TRUE(tree->search(42));
+    EXPECT_EQ(tree->size(), 1);
+}
+
+TEST_F(AVLTreeTest, StringNodesDestroyedOnClearAndRemove) {
+    AVLTree<std::string> words;
+    for (int i = 0; i < 300; i++) {
+        // Длинные строки - в куче, утечку или двойное освобождение увидит санитайзер
+        words.insert(std::string(40, 'a') + std::to_string(i));
+    }
+    for (int i = 0; i < 300; i += 3) {
+        words.remove(std::string(40, 'a') + std::to_string(i));
+    }
+    EXPECT_EQ(words.size(), 200u);
+    words.clear();
+    EXPECT_TRUE(words.empty());
+    words.insert("after");
+    EXPECT_TRUE(words.search("after"));
+}
+
+TEST_F(AVLTreeTest, MoveTransfersPool) {
+    for (int i = 0; i < 100; i++) {
+        tree->insert(i);
+    }
+    AVLTree<int> moved(std::move(*tree));
+    EXPECT_TRUE(tree->empty());
+    EXPECT_EQ(tree->memoryUsage(), 0u);
+    EXPECT_EQ(moved.size(), 100);
+    EXPECT_TRUE(moved.search(99));
+
+    AVLTree<int> assigned;
+    assigned.insert(-1);
+    assigned = std::move(moved);
+    EXPECT_FALSE(assigned.search(-1));
+    EXPECT_TRUE(assigned.search(50));
+    assigned.insert(100);
+    EXPECT_EQ(assigned.size(), 101);
+
+    // Исходное дерево после переноса остаётся рабочим
+    tree->insert(7);
+    EXPECT_TRUE(tree->search(7));
+}
+
+TEST_F(AVLTreeTest, RandomOperationsKeepAVLHeight) {
+    std::mt19937 rng(11);
+    std::set<int> reference;
+    for (int step = 0; step < 200000; step++) {
+        int value = static_cast<int>(rng() % 20000);
+        if (rng() % 3 == 0) {
+            tree->remove(value);
+            reference.erase(value);
+        } else {
+            tree->insert(value);
+            reference.insert(value);
+        }
+    }
+    EXPECT_EQ(tree->size(), reference.size());
+    for (int value = 0; value < 20000; value++) {
+        EXPECT_EQ(tree->search(value), reference.count(value) == 1);
+    }
+    // Высота AVL-дерева меньше 1.44 * log2(n + 2)
+    EXPECT_LT(tree->height(), 1.44 * std::log2(static_cast<double>(tree->size()) + 2));
+}
+
+TEST_F(AVLTreeTest, StringBinarySerialization) {
+    AVLTree<std::string> words;
+    for (int i = 0; i < 1000; i++) {
+        words.insert("key" + std::to_string(i));
+    }
+    std::ofstream out("test_avltree_str.bin", std::ios::binary);
+    words.saveToBinary(out);
+    out.close();
+
+    AVLTree<std::string> loaded;
+    std::ifstream in("test_avltree_str.bin", std::ios::binary);
+    loaded.loadFromBinary(in);
+    in.close();
+    std::remove("test_avltree_str.bin");
+
+    EXPECT_EQ(loaded.size(), 1000u);
+    EXPECT_EQ(loaded.height(), words.height());
+    EXPECT_TRUE(loaded.search("key999"));
+    EXPECT_FALSE(loaded.search("key1000"));
+}
+
+namespace {
+
+// Снимок дерева, каждый узел которого - правый ребёнок предыдущего
+void writeRightChain(const char* filename, uint32_t nodes) {
+    std::ofstream out(filename, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&nodes), sizeof(nodes));
+    for (uint32_t i = 0; i < nodes; i++) {
+        uint8_t node = 1, empty = 0;
+        int value = static_cast<int>(i);
+        out.write(reinterpret_cast<const char*>(&node), 1);
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        out.write(reinterpret_cast<const char*>(&empty), 1);
+    }
+    uint8_t empty = 0;
+    out.write(reinterpret_cast<const char*>(&empty), 1);
+}
+
+}
+
+TEST_F(AVLTreeTest, DegenerateSnapshotRejected) {
+    // Миллион узлов в цепочке: рекурсивная загрузка переполнила бы стек
+    writeRightChain("test_avltree_chain.bin", 1000000);
+    std::ifstream in("test_avltree_chain.bin", std::ios::binary);
+    EXPECT_THROW(tree->loadFromBinary(in), std::runtime_error);
+    in.close();
+    std::remove("test_avltree_chain.bin");
+
+    EXPECT_TRUE(tree->empty());
+    EXPECT_EQ(tree->memoryUsage(), 0u);
+    tree->insert(1);
+    EXPECT_TRUE(tree->search(1));
+}
+
+TEST_F(AVLTreeTest, TruncatedSnapshotRejected) {
+    for (int i = 0; i < 100; i++) {
+        tree->insert(i);
+    }
+    std::ofstream out("test_avltree_cut.bin", std::ios::binary);
+    tree->saveToBinary(out);
+    out.close();
+    std::ifstream whole("test_avltree_cut.bin", std::ios::binary | std::ios::ate);
+    std::streamsize fullSize = whole.tellg();
+    whole.close();
+
+    // Обрезанный файл и файл с чужим маркером
+    std::string bytes(static_cast<size_t>(fullSize), '\0');
+    std::ifstream src("test_avltree_cut.bin", std::ios::binary);
+    src.read(&bytes[0], fullSize);
+    src.close();
+    for (int variant = 0; variant < 2; variant++) {
+        std::string broken = bytes;
+        if (variant == 0) {
+            broken.resize(broken.size() / 2);
+        } else {
+            broken[4] = 7;
+        }
+        std::ofstream bad("test_avltree_cut.bin", std::ios::binary);
+        bad.write(broken.data(), static_cast<std::streamsize>(broken.size()));
+        bad.close();
+
+        AVLTree<int> loaded;
+        std::ifstream in("test_avltree_cut.bin", std::ios::binary);
+        EXPECT_THROW(loaded.loadFromBinary(in), std::runtime_error);
+        EXPECT_TRUE(loaded.empty());
+    }
+    std::remove("test_avltree_cut.bin");
+}
+
+TEST_F(AVLTreeTest, RankSelectCountRange) {
+    std::mt19937 rng(5);
+    std::set<int> reference;
+    for (int step = 0; step < 50000; step++) {
+        int value = static_cast<int>(rng() % 10000);
+        if (rng() % 4 == 0) {
+            tree->remove(value);
+            reference.erase(value);
+        } else {
+            tree->insert(value);
+            reference.insert(value);
+        }
+    }
+    std::vector<int> sorted(reference.begin(), reference.end());
+    for (size_t k = 0; k < sorted.size(); k++) {
+        EXPECT_EQ(tree->select(k), sorted[k]);
+        EXPECT_EQ(tree->rank(sorted[k]), k);
+    }
+    EXPECT_THROW(tree->select(sorted.size()), std::out_of_range);
+
+    for (int i = 0; i < 1000; i++) {
+        int lo = static_cast<int>(rng() % 11000) - 500;
+        int hi = static_cast<int>(rng() % 11000) - 500;
+        size_t expected = lo > hi ? 0 : static_cast<size_t>(std::distance(reference.lower_bound(lo), reference.upper_bound(hi)));
+        EXPECT_EQ(tree->countRange(lo, hi), expected);
+        EXPECT_EQ(tree->rank(lo), static_cast<size_t>(std::distance(reference.begin(), reference.lower_bound(lo))));
+    }
+}
+
+TEST_F(AVLTreeTest, SumAggregateOverRange) {
+    AVLTree<long long, SumAggregate<long long>> scores;
+    std::set<long long> reference;
+    std::mt19937 rng(9);
+    for (int step = 0; step < 20000; step++) {
+        long long value = static_cast<long long>(rng() % 5000);
+        if (rng() % 3 == 0) {
+            scores.remove(value);
+            reference.erase(value);
+        } else {
+            scores.insert(value);
+            reference.insert(value);
+        }
+    }
+    for (int i = 0; i < 500; i++) {
+        long long lo = static_cast<long long>(rng() % 5200) - 100;
+        long long hi = lo + static_cast<long long>(rng() % 2000);
+        long long expected = 0;
+        for (auto it = reference.lower_bound(lo); it != reference.end() && *it <= hi; ++it) {
+            expected += *it;
+        }
+        EXPECT_EQ(scores.aggregateRange(lo, hi), expected);
+    }
+    EXPECT_EQ(scores.aggregateRange(10, 5), 0);
+}
+
+namespace {
+
+// Склейка строк: не коммутативна, проверяет порядок сборки агрегата
+struct ConcatAggregate {
+    using value_type = std::string;
+    static std::string identity() { return ""; }
+    static std::string of(const std::string& value) { return value; }
+    static std::string combine(const std::string& a, const std::string& b) { return a + b; }
+};
+
+// Агрегат с нетривиальным деструктором над тривиальными данными:
+// живые значения считаются, утечка видна после clear()
+struct CountedSum {
+    static int live;
+    long long total;
+    CountedSum(long long t = 0) : total(t) { live++; }
+    CountedSum(const CountedSum& other) : total(other.total) { live++; }
+    CountedSum& operator=(const CountedSum& other) { total = other.total; return *this; }
+    ~CountedSum() { live--; }
+};
+int CountedSum::live = 0;
+
+struct CountedSumAggregate {
+    using value_type = CountedSum;
+    static CountedSum identity() { return CountedSum(); }
+    static CountedSum of(int value) { return CountedSum(value); }
+    static CountedSum combine(const CountedSum& a, const CountedSum& b) { return CountedSum(a.total + b.total); }
+};
+
+}
+
+TEST_F(AVLTreeTest, ClearDestroysNonTrivialAggregates) {
+    {
+        AVLTree<int, CountedSumAggregate> counted;
+        for (int i = 0; i < 1000; i++) {
+            counted.insert(i);
+        }
+        EXPECT_EQ(counted.aggregateRange(0, 999).total, 999 * 1000 / 2);
+        counted.clear();
+        EXPECT_EQ(CountedSum::live, 0);
+        counted.insert(5);
+    }
+    EXPECT_EQ(CountedSum::live, 0);
+}
+
+TEST_F(AVLTreeTest, AggregateKeepsInOrder) {
+    AVLTree<std::string, ConcatAggregate> letters;
+    for (char c : std::string("qwertyuiopasdfghjklzxcvbnm")) {
+        letters.insert(std::string(1, c));
+    }
+    letters.remove("k");
+    EXPECT_EQ(letters.aggregateRange(std::string("a"), std::string("z")), "abcdefghijlmnopqrstuvwxyz");
+    EXPECT_EQ(letters.aggregateRange(std::string("d"), std::string("m")), "defghijlm");
+    EXPECT_EQ(letters.aggregateRange(std::string("k"), std::string("k")), "");
+}
+
+TEST_F(AVLTreeTest, SizesRestoredAfterBinaryLoad) {
+    for (int i = 0; i < 1000; i++) {
+        tree->insert(i * 3);
+    }
+    std::ofstream out("test_avltree_rank.bin", std::ios::binary);
+    tree->saveToBinary(out);
+    out.close();
+    AVLTree<int> loaded;
+    std::ifstream in("test_avltree_rank.bin", std::ios::binary);
+    loaded.loadFromBinary(in);
+    in.close();
+    std::remove("test_avltree_rank.bin");
+
+    EXPECT_EQ(loaded.select(500), 1500);
+    EXPECT_EQ(loaded.rank(1501), 501u);
+    EXPECT_EQ(loaded.countRange(0, 299), 100u);
+}
+
+TEST_F(AVLTreeTest, IteratorsMatchStdSet) {
+    EXPECT_TRUE(tree->begin() == tree->end());
+
+    std::mt19937 rng(21);
+    std::set<int> reference;
+    for (int step = 0; step < 30000; step++) {
+        int value = static_cast<int>(rng() % 5000);
+        if (rng() % 3 == 0) {
+            tree->remove(value);
+            reference.erase(value);
+        } else {
+            tree->insert(value);
+            reference.insert(value);
+        }
+    }
+    std::vector<int> forward(tree->begin(), tree->end());
+    EXPECT_EQ(forward, std::vector<int>(reference.begin(), reference.end()));
+
+    std::vector<int> backward;
+    for (auto it = tree->end(); it != tree->begin(); ) {
+        backward.push_back(*--it);
+    }
+    EXPECT_EQ(backward, std::vector<int>(reference.rbegin(), reference.rend()));
+    EXPECT_EQ(*std::prev(tree->end()), *reference.rbegin());
+    EXPECT_EQ(static_cast<size_t>(std::distance(tree->begin(), tree->end())), tree->size());
+}
+
+TEST_F(AVLTreeTest, LowerUpperBound) {
+    for (int i = 0; i < 100; i += 10) {
+        tree->insert(i);
+    }
+    EXPECT_EQ(*tree->lower_bound(30), 30);
+    EXPECT_EQ(*tree->upper_bound(30), 40);
+    EXPECT_EQ(*tree->lower_bound(31), 40);
+    EXPECT_EQ(*tree->lower_bound(-5), 0);
+    EXPECT_TRUE(tree->lower_bound(91) == tree->end());
+    EXPECT_TRUE(tree->upper_bound(90) == tree->end());
+
+    // Отрезок [25, 65]
+    std::vector<int> range;
+    for (auto it = tree->lower_bound(25); it != tree->end() && *it <= 65; ++it) {
+        range.push_back(*it);
+    }
+    EXPECT_EQ(range, (std::vector<int>{30, 40, 50, 60}));
+
+    AVLTree<std::string> words;
+    for (const char* word : {"pear", "apple", "plum", "fig"}) {
+        words.insert(word);
+    }
+    EXPECT_EQ(*words.lower_bound(std::string_view("g")), "pear");
+    EXPECT_EQ(words.lower_bound(std::string_view("fig"))->size(), 3u);
+}
+
+TEST_F(AVLTreeTest, IteratorsAfterBinaryLoad) {
+    for (int i = 0; i < 500; i++) {
+        tree->insert(i);
+    }
+    std::ofstream out("test_avltree_iter.bin", std::ios::binary);
+    tree->saveToBinary(out);
+    out.close();
+    AVLTree<int> loaded;
+    std::ifstream in("test_avltree_iter.bin", std::ios::binary);
+    loaded.loadFromBinary(in);
+    in.close();
+    std::remove("test_avltree_iter.bin");
+
+    std::vector<int> values(loaded.begin(), loaded.end());
+    ASSERT_EQ(values.size(), 500u);
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+    EXPECT_EQ(*--loaded.end(), 499);
+    auto it = loaded.lower_bound(250);
+    EXPECT_EQ(*--it, 249);
+
+    // После удаления и вставки родители остаются верными
+    loaded.remove(249);
+    loaded.insert(1000);
+    values.assign(loaded.begin(), loaded.end());
+    EXPECT_EQ(values.size(), 500u);
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST_F(AVLTreeTest, BulkLoadSortedBuildsMinimalTree) {
+    std::vector<int> values;
+    for (int i = 0; i < 100000; i++) {
+        values.push_back(i * 2);
+    }
+    tree->insert(-1);
+    tree->bulkLoad(values);
+
+    EXPECT_EQ(tree->size(), 100000u);
+    EXPECT_FALSE(tree->search(-1));
+    // 2^16 <= 100000 < 2^17: высота полного дерева - 17
+    EXPECT_EQ(tree->height(), 17);
+    EXPECT_EQ(std::vector<int>(tree->begin(), tree->end()), values);
+    EXPECT_EQ(*std::prev(tree->end()), 199998);
+    EXPECT_EQ(tree->select(12345), 24690);
+    EXPECT_EQ(tree->rank(1001), 501u);
+
+    // После построения дерево - обычное AVL
+    for (int i = 1; i < 2000; i += 2) {
+        tree->insert(i);
+    }
+    for (int i = 0; i < 4000; i += 4) {
+        tree->remove(i);
+    }
+    std::vector<int> after(tree->begin(), tree->end());
+    EXPECT_EQ(after.size(), 100000u);
+    EXPECT_TRUE(std::is_sorted(after.begin(), after.end()));
+    EXPECT_LT(tree->height(), 1.44 * std::log2(static_cast<double>(tree->size()) + 2));
+}
+
+TEST_F(AVLTreeTest, BulkLoadUnsortedWithDuplicates) {
+    tree->bulkLoad({5, 3, 9, 3, 1, 9, 7});
+    EXPECT_EQ(tree->size(), 5u);
+    EXPECT_EQ(std::vector<int>(tree->begin(), tree->end()), (std::vector<int>{1, 3, 5, 7, 9}));
+
+    tree->bulkLoad({});
+    EXPECT_TRUE(tree->empty());
+    EXPECT_TRUE(tree->begin() == tree->end());
+
+    AVLTree<long long, SumAggregate<long long>> sums;
+    sums.bulkLoad({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+    EXPECT_EQ(sums.aggregateRange(3LL, 7LL), 25);
+    sums.insert(11);
+    EXPECT_EQ(sums.aggregateRange(0LL, 100LL), 66);
+}
+
+TEST_F(AVLTreeTest, LoadFromFileRoundTrip) {
+    AVLTree<std::string> words;
+    for (int i = 0; i < 1000; i++) {
+        words.insert("w" + std::to_string(i));
+    }
+    words.saveToFile("test_avltree.txt");
+
+    AVLTree<std::string> loaded;
+    loaded.loadFromFile("test_avltree.txt");
+    std::remove("test_avltree.txt");
+    EXPECT_EQ(loaded.size(), 1000u);
+    EXPECT_EQ(std::vector<std::string>(loaded.begin(), loaded.end()),
+              std::vector<std::string>(words.begin(), words.end()));
+    EXPECT_LE(loaded.height(), words.height());
+}
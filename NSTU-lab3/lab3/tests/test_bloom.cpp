@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "../src/containers/hash.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST(BloomFilterTest, EmptyFilterRejectsEverything) {
+    BloomFilter<int> filter;
+    EXPECT_TRUE(filter.empty());
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_FALSE(filter.mightContain(i));
+    }
+}
+
+TEST(BloomFilterTest, NoFalseNegatives) {
+    BloomFilter<int> filter(10000, 0.01);
+    for (int i = 0; i < 10000; i++) {
+        filter.add(i * 7);
+    }
+    EXPECT_EQ(filter.size(), 10000u);
+    for (int i = 0; i < 10000; i++) {
+        EXPECT_TRUE(filter.mightContain(i * 7));
+    }
+}
+
+TEST(BloomFilterTest, FalsePositiveRateNearTarget) {
+    const int n = 100000;
+    for (double target : {0.05, 0.01, 0.001}) {
+        BloomFilter<int> filter(n, target);
+        for (int i = 0; i < n; i++) {
+            filter.add(i);
+        }
+        int falsePositives = 0;
+        for (int i = n; i < 11 * n; i++) {
+            falsePositives += filter.mightContain(i);
+        }
+        double measured = static_cast<double>(falsePositives) / (10.0 * n);
+        EXPECT_LT(measured, target * 1.3) << "цель " << target;
+        EXPECT_LE(filter.falsePositiveRate(), target);
+        EXPECT_GT(filter.falsePositiveRate(), target / 2);
+    }
+}
+
+TEST(BloomFilterTest, StricterRateNeedsMoreBits) {
+    BloomFilter<int> loose(100000, 0.01);
+    BloomFilter<int> strict(100000, 0.0001);
+    EXPECT_GT(strict.bitCount(), loose.bitCount());
+    EXPECT_GT(strict.hashFunctions(), loose.hashFunctions());
+    // Блоки по 512 бит; около 10 бит на ключ для 1%
+    EXPECT_EQ(loose.bitCount() % 512, 0u);
+    EXPECT_LT(loose.bitCount(), 100000u * 12);
+}
+
+TEST(BloomFilterTest, InvalidRateThrows) {
+    EXPECT_THROW(BloomFilter<int>(100, 0.0), std::runtime_error);
+    EXPECT_THROW(BloomFilter<int>(100, 1.0), std::runtime_error);
+}
+
+TEST(BloomFilterTest, BatchMatchesSingleLookups) {
+    BloomFilter<std::string> filter(1000, 0.01);
+    std::vector<std::string> stored;
+    for (int i = 0; i < 1000; i++) {
+        stored.push_back("user:" + std::to_string(i));
+        filter.add(stored.back());
+    }
+    std::vector<std::string_view> probes;
+    for (int i = 0; i < 2000; i++) {
+        probes.push_back(stored[i % 1000]);
+    }
+    std::vector<std::string> absent;
+    for (int i = 0; i < 1000; i++) {
+        absent.push_back("guest:" + std::to_string(i));
+    }
+    for (const std::string& key : absent) {
+        probes.push_back(key);
+    }
+
+    std::vector<bool> results = filter.mightContainMany(probes);
+    ASSERT_EQ(results.size(), probes.size());
+    for (size_t i = 0; i < probes.size(); i++) {
+        EXPECT_EQ(results[i], filter.mightContain(probes[i]));
+    }
+    for (size_t i = 0; i < 2000; i++) {
+        EXPECT_TRUE(results[i]);
+    }
+}
+
+TEST(BloomFilterTest, TransparentAddMatchesStringAdd) {
+    BloomFilter<std::string> byString(1000, 0.01);
+    BloomFilter<std::string> byView(1000, 0.01);
+    std::string buffer = "alpha beta gamma delta";
+    for (size_t start = 0, end; start < buffer.size(); start = end + 1) {
+        end = std::min(buffer.find(' ', start), buffer.size());
+        std::string_view word = std::string_view(buffer).substr(start, end - start);
+        byString.add(std::string(word));
+        byView.add(word);
+    }
+    EXPECT_EQ(byView.size(), 4u);
+    for (const char* key : {"alpha", "beta", "gamma", "delta", "omega", "beta "}) {
+        EXPECT_EQ(byView.mightContain(key), byString.mightContain(key));
+    }
+    EXPECT_TRUE(byView.mightContain(std::string_view("gamma")));
+}
+
+TEST(BloomFilterTest, ClearForgetsKeys) {
+    BloomFilter<int> filter(100, 0.01);
+    filter.add(42);
+    filter.clear();
+    EXPECT_TRUE(filter.empty());
+    EXPECT_FALSE(filter.mightContain(42));
+}
+
+TEST(BloomFilterTest, BinarySerialization) {
+    BloomFilter<std::string> filter(5000, 0.02);
+    for (int i = 0; i < 5000; i++) {
+        filter.add("key" + std::to_string(i));
+    }
+
+    std::ofstream out("test_bloom.bin", std::ios::binary);
+    filter.saveToBinary(out);
+    out.close();
+
+    // Размеры берутся из снимка, а не из конструктора
+    BloomFilter<std::string> loaded(1, 0.5);
+    std::ifstream in("test_bloom.bin", std::ios::binary);
+    loaded.loadFromBinary(in);
+    in.close();
+
+    EXPECT_EQ(loaded.size(), 5000u);
+    EXPECT_EQ(loaded.bitCount(), filter.bitCount());
+    EXPECT_EQ(loaded.hashFunctions(), filter.hashFunctions());
+    for (int i = 0; i < 10000; i++) {
+        std::string key = "key" + std::to_string(i);
+        EXPECT_EQ(loaded.mightContain(key), filter.mightContain(key));
+    }
+
+    std::remove("test_bloom.bin");
+}
+
+TEST(BloomFilterTest, CorruptSnapshotThrows) {
+    BloomFilter<int> filter(100000, 0.01);
+    filter.add(7);
+    std::ofstream out("test_bloom_bad.bin", std::ios::binary);
+    filter.saveToBinary(out);
+    out.close();
+
+    // Обрезанный снимок: блоков в файле меньше, чем в заголовке
+    std::ifstream whole("test_bloom_bad.bin", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(whole)), std::istreambuf_iterator<char>());
+    whole.close();
+    std::ofstream truncated("test_bloom_bad.bin", std::ios::binary | std::ios::trunc);
+    truncated.write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+    truncated.close();
+
+    BloomFilter<int> loaded(10, 0.01);
+    size_t bits = loaded.bitCount();
+    std::ifstream in("test_bloom_bad.bin", std::ios::binary);
+    EXPECT_THROW(loaded.loadFromBinary(in), std::runtime_error);
+    in.close();
+    EXPECT_EQ(loaded.bitCount(), bits);
+
+    // Заголовок с огромным числом блоков и без данных
+    std::ofstream huge("test_bloom_bad.bin", std::ios::binary | std::ios::trunc);
+    writeBinary(huge, size_t(1));
+    writeBinary(huge, uint32_t(4));
+    writeBinary(huge, SIZE_MAX / 2);
+    huge.close();
+    std::ifstream hugeIn("test_bloom_bad.bin", std::ios::binary);
+    EXPECT_THROW(loaded.loadFromBinary(hugeIn), std::runtime_error);
+    hugeIn.close();
+
+    std::ofstream large("test_bloom_bad.bin", std::ios::binary | std::ios::trunc);
+    writeBinary(large, size_t(1));
+    writeBinary(large, uint32_t(4));
+    writeBinary(large, size_t(1) << 40);
+    large.close();
+    std::ifstream largeIn("test_bloom_bad.bin", std::ios::binary);
+    EXPECT_THROW(loaded.loadFromBinary(largeIn), std::runtime_error);
+    largeIn.close();
+    EXPECT_EQ(loaded.bitCount(), bits);
+
+    std::remove("test_bloom_bad.bin");
+}
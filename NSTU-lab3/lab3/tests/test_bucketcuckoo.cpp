@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "../src/containers/hash.h"
+#include <sstream>
+#include <unordered_map>
+#include <random>
+
+class BucketCuckooHashMapTest : public ::testing::Test {
+protected:
+    BucketCuckooHashMap<std::string, int>* map;
+
+    void SetUp() override {
+        map = new BucketCuckooHashMap<std::string, int>();
+    }
+
+    void TearDown() override {
+        delete map;
+    }
+};
+
+TEST_F(BucketCuckooHashMapTest, DefaultConstructor) {
+    EXPECT_TRUE(map->empty());
+    EXPECT_EQ(map->size(), 0);
+}
+
+TEST_F(BucketCuckooHashMapTest, PutGetUpdate) {
+    map->put("a", 1);
+    map->put("b", 2);
+    map->put("a", 10);
+    EXPECT_EQ(map->size(), 2);
+    EXPECT_EQ(map->get("a"), 10);
+    EXPECT_EQ(map->get("b"), 2);
+    EXPECT_THROW(map->get("c"), std::runtime_error);
+}
+
+TEST_F(BucketCuckooHashMapTest, ContainsAndRemove) {
+    map->put("key", 1);
+    EXPECT_TRUE(map->contains("key"));
+    EXPECT_TRUE(map->remove("key"));
+    EXPECT_FALSE(map->contains("key"));
+    EXPECT_FALSE(map->remove("key"));
+    EXPECT_TRUE(map->empty());
+}
+
+TEST_F(BucketCuckooHashMapTest, Clear) {
+    for (int i = 0; i < 100; i++) {
+        map->put("k" + std::to_string(i), i);
+    }
+    map->clear();
+    EXPECT_TRUE(map->empty());
+    EXPECT_FALSE(map->contains("k5"));
+    map->put("k5", 5);
+    EXPECT_EQ(map->get("k5"), 5);
+}
+
+TEST_F(BucketCuckooHashMapTest, GrowsAndKeepsAllKeys) {
+    for (int i = 0; i < 5000; i++) {
+        map->put("key" + std::to_string(i), i);
+    }
+    EXPECT_EQ(map->size(), 5000);
+    for (int i = 0; i < 5000; i++) {
+        EXPECT_EQ(map->get("key" + std::to_string(i)), i);
+    }
+}
+
+TEST_F(BucketCuckooHashMapTest, ReachesHighLoadBeforeGrowing) {
+    // Таблица растёт только на пороге 95% или при неудаче поиска пути:
+    // перед каждым ростом заполненность должна быть не ниже 90%
+    BucketCuckooHashMap<int, int> ints(1024);
+    size_t slots = ints.bucketCount();
+    double lastLoad = 0.0;
+    int growths = 0;
+    for (int i = 0; i < 200000; i++) {
+        ints.put(i * 7919, i);
+        if (ints.bucketCount() != slots) {
+            EXPECT_GE(lastLoad, 0.9);
+            slots = ints.bucketCount();
+            growths++;
+        }
+        lastLoad = ints.loadFactor();
+    }
+    EXPECT_GT(growths, 0);
+}
+
+TEST_F(BucketCuckooHashMapTest, EightWayBuckets) {
+    BucketCuckooHashMap<int, int, 8> wide(16);
+    for (int i = 0; i < 10000; i++) {
+        wide.put(i, -i);
+    }
+    EXPECT_EQ(wide.size(), 10000);
+    EXPECT_EQ(wide.get(1234), -1234);
+    EXPECT_EQ(wide.bucketCount() % 8, 0u);
+}
+
+TEST_F(BucketCuckooHashMapTest, RandomOperationsMatchUnorderedMap) {
+    BucketCuckooHashMap<int, int> table;
+    std::unordered_map<int, int> reference;
+    std::mt19937 rng(42);
+    for (int step = 0; step < 50000; step++) {
+        int key = static_cast<int>(rng() % 4000);
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(table.remove(key), reference.erase(key) == 1);
+        } else {
+            table.put(key, step);
+            reference[key] = step;
+        }
+    }
+    EXPECT_EQ(table.size(), reference.size());
+    for (const auto& [key, value] : reference) {
+        EXPECT_EQ(table.get(key), value);
+    }
+}
+
+struct ConstantHash {
+    size_t operator()(int) const {
+        return 7;
+    }
+};
+
+TEST_F(BucketCuckooHashMapTest, DegenerateHashThrows) {
+    // У всех ключей одни и те же две корзины: 2 * 4 слота
+    BucketCuckooHashMap<int, int, 4, ConstantHash> degenerate;
+    for (int i = 0; i < 8; i++) {
+        degenerate.put(i, i);
+    }
+    EXPECT_THROW(degenerate.put(8, 8), std::runtime_error);
+    EXPECT_EQ(degenerate.size(), 8);
+    EXPECT_EQ(degenerate.get(3), 3);
+}
+
+TEST_F(BucketCuckooHashMapTest, Print) {
+    map->put("x", 1);
+    std::ostringstream os;
+    map->print(os);
+    EXPECT_NE(os.str().find("x => 1"), std::string::npos);
+    EXPECT_NE(os.str().find("(size: 1)"), std::string::npos);
+}
@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "../src/containers/hash.h"
+#include <sstream>
+#include <cstdio>
+#include <iterator>
+
+class CompactStringMapTest : public ::testing::Test {
+protected:
+    CompactStringMap* map;
+
+    void SetUp() override {
+        map = new CompactStringMap();
+    }
+
+    void TearDown() override {
+        delete map;
+    }
+};
+
+TEST_F(CompactStringMapTest, DefaultConstructor) {
+    EXPECT_TRUE(map->empty());
+    EXPECT_EQ(map->size(), 0);
+    EXPECT_EQ(map->arenaBytes(), 0);
+}
+
+TEST_F(CompactStringMapTest, PutAndGet) {
+    map->put("key1", "value1");
+    EXPECT_EQ(map->size(), 1);
+    EXPECT_EQ(map->get("key1"), "value1");
+    EXPECT_THROW(map->get("key2"), std::runtime_error);
+}
+
+TEST_F(CompactStringMapTest, UpdateValue) {
+    map->put("key", "aaa");
+    map->put("key", "bbb");
+    // Значение той же длины перезаписывается на месте
+    size_t bytes = map->arenaBytes();
+    EXPECT_EQ(map->get("key"), "bbb");
+    map->put("key", "longer value");
+    EXPECT_EQ(map->size(), 1);
+    EXPECT_EQ(map->get("key"), "longer value");
+    EXPECT_GT(map->arenaBytes(), bytes);
+}
+
+TEST_F(CompactStringMapTest, FindWithoutCopy) {
+    map->put("key", "value");
+    std::string_view value;
+    ASSERT_TRUE(map->find("key", value));
+    EXPECT_EQ(value, "value");
+    EXPECT_FALSE(map->find("other", value));
+    // Значение из арены можно записать обратно под другим ключом
+    ASSERT_TRUE(map->find("key", value));
+    map->put(value, value);
+    EXPECT_EQ(map->get("value"), "value");
+}
+
+TEST_F(CompactStringMapTest, RemoveAndGrow) {
+    for (int i = 0; i < 5000; i++) {
+        map->put("key" + std::to_string(i), std::to_string(i));
+    }
+    for (int i = 0; i < 5000; i += 2) {
+        EXPECT_TRUE(map->remove("key" + std::to_string(i)));
+    }
+    EXPECT_FALSE(map->remove("key0"));
+    EXPECT_EQ(map->size(), 2500);
+    for (int i = 0; i < 5000; i++) {
+        EXPECT_EQ(map->contains("key" + std::to_string(i)), i % 2 == 1);
+    }
+    EXPECT_EQ(map->get("key4999"), "4999");
+}
+
+TEST_F(CompactStringMapTest, CompactsArena) {
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 50; i++) {
+            map->put("key" + std::to_string(i), "value" + std::to_string(round * 1000 + i));
+        }
+    }
+    EXPECT_EQ(map->size(), 50);
+    // Мусор от перезаписей не превышает объём живых данных
+    size_t live = 0;
+    map->forEach([&live](std::string_view key, std::string_view value) {
+        live += 2 * sizeof(uint32_t) + key.size() + value.size();
+    });
+    EXPECT_LE(map->arenaBytes(), 2 * live);
+    EXPECT_EQ(map->get("key7"), "value99007");
+}
+
+TEST_F(CompactStringMapTest, SmallerThanHashMap) {
+    HashMap<std::string, std::string> wide;
+    for (int i = 0; i < 10000; i++) {
+        map->put("k" + std::to_string(i), "v" + std::to_string(i));
+        wide.put("k" + std::to_string(i), "v" + std::to_string(i));
+    }
+    size_t wideBytes = wide.bucketCount() * (2 * sizeof(std::string) + sizeof(size_t) + 8);
+    EXPECT_LT(map->memoryUsage(), wideBytes / 2);
+}
+
+TEST_F(CompactStringMapTest, ForEachVisitsLiveRecords) {
+    map->put("a", "1");
+    map->put("b", "2");
+    map->put("c", "3");
+    map->remove("b");
+    std::string seen;
+    map->forEach([&seen](std::string_view key, std::string_view value) {
+        seen += std::string(key) + "=" + std::string(value) + ";";
+    });
+    EXPECT_EQ(seen, "a=1;c=3;");
+}
+
+TEST_F(CompactStringMapTest, EmptyKeyAndValueAtArenaEnd) {
+    // Последняя запись с пустым значением: адрес значения - конец арены
+    map->put("k", "");
+    map->put("k", "");
+    EXPECT_EQ(map->size(), 1);
+    EXPECT_EQ(map->get("k"), "");
+
+    // Пустой ключ и пустое значение - запись из одного заголовка
+    map->put("", "");
+    std::string_view value = "x";
+    EXPECT_TRUE(map->find("", value));
+    EXPECT_EQ(value, "");
+    EXPECT_TRUE(map->contains(""));
+    map->put("", "");
+    EXPECT_EQ(map->size(), 2);
+
+    std::string seen;
+    map->forEach([&seen](std::string_view key, std::string_view v) {
+        seen += "[" + std::string(key) + "=" + std::string(v) + "]";
+    });
+    EXPECT_NE(seen.find("[k=]"), std::string::npos);
+    EXPECT_NE(seen.find("[=]"), std::string::npos);
+    EXPECT_EQ(seen.size(), 7u);
+}
+
+TEST_F(CompactStringMapTest, Clear) {
+    map->put("a", "1");
+    map->clear();
+    EXPECT_TRUE(map->empty());
+    EXPECT_FALSE(map->contains("a"));
+    EXPECT_EQ(map->arenaBytes(), 0);
+}
+
+TEST_F(CompactStringMapTest, BinarySerializationCompatibleWithHashMap) {
+    for (int i = 0; i < 200; i++) {
+        map->put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    map->remove("key5");
+
+    const std::string filename = "test_compactmap.bin";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        map->saveToBinary(out);
+    }
+    HashMap<std::string, std::string> loaded;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        loaded.loadFromBinary(in);
+    }
+    EXPECT_EQ(loaded.size(), 199);
+    EXPECT_EQ(loaded.get("key150"), "value150");
+
+    {
+        std::ofstream out(filename, std::ios::binary);
+        loaded.saveToBinary(out);
+    }
+    CompactStringMap reloaded;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        reloaded.loadFromBinary(in);
+    }
+    std::remove(filename.c_str());
+    EXPECT_EQ(reloaded.size(), 199);
+    EXPECT_FALSE(reloaded.contains("key5"));
+    EXPECT_EQ(reloaded.get("key199"), "value199");
+}
+
+TEST_F(CompactStringMapTest, TruncatedSnapshotThrows) {
+    for (int i = 0; i < 3; i++) {
+        map->put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    const std::string filename = "test_compactmap_bad.bin";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        map->saveToBinary(out);
+    }
+    std::string bytes;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // Заголовок короче 4 байт, обрезанное тело, огромное число элементов
+    std::string hugeCount = "\xF0\xFF\xFF\xFF";
+    for (const std::string& broken : {bytes.substr(0, 2), bytes.substr(0, bytes.size() - 6), hugeCount}) {
+        {
+            std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+            out.write(broken.data(), static_cast<std::streamsize>(broken.size()));
+        }
+        CompactStringMap loaded;
+        loaded.put("stale", "value");
+        std::ifstream in(filename, std::ios::binary);
+        EXPECT_THROW(loaded.loadFromBinary(in), std::runtime_error);
+        EXPECT_TRUE(loaded.empty());
+    }
+    std::remove(filename.c_str());
+}
+
+TEST_F(CompactStringMapTest, Print) {
+    map->put("key", "value");
+    std::ostringstream oss;
+    map->print(oss);
+    EXPECT_NE(oss.str().find("key => value"), std::string::npos);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "../src/containers/hash.h"
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class ConcurrentCuckooHashMapTest : public ::testing::Test {
+protected:
+    ConcurrentCuckooHashMap<int, int>* map;
+
+    void SetUp() override {
+        map = new ConcurrentCuckooHashMap<int, int>(16);
+    }
+
+    void TearDown() override {
+        delete map;
+    }
+};
+
+TEST_F(ConcurrentCuckooHashMapTest, SingleThreadOperations) {
+    EXPECT_TRUE(map->empty());
+    map->put(1, 10);
+    map->put(2, 20);
+    map->put(1, 11);
+    EXPECT_EQ(map->size(), 2);
+    EXPECT_EQ(map->get(1), 11);
+    int value = 0;
+    EXPECT_TRUE(map->tryGet(2, value));
+    EXPECT_EQ(value, 20);
+    EXPECT_FALSE(map->tryGet(3, value));
+    EXPECT_THROW(map->get(3), std::runtime_error);
+    EXPECT_TRUE(map->remove(1));
+    EXPECT_FALSE(map->remove(1));
+    EXPECT_FALSE(map->contains(1));
+    map->clear();
+    EXPECT_TRUE(map->empty());
+    EXPECT_FALSE(map->contains(2));
+}
+
+TEST_F(ConcurrentCuckooHashMapTest, GrowsAndKeepsHighLoad) {
+    for (int i = 0; i < 50000; i++) {
+        map->put(i, -i);
+    }
+    EXPECT_EQ(map->size(), 50000);
+    for (int i = 0; i < 50000; i++) {
+        EXPECT_EQ(map->get(i), -i);
+    }
+    // Рост только при неудаче поиска пути: таблица заполнена плотно
+    EXPECT_GT(static_cast<double>(map->size()) / map->bucketCount(), 0.4);
+}
+
+TEST_F(ConcurrentCuckooHashMapTest, RandomOperationsMatchUnorderedMap) {
+    std::unordered_map<int, int> reference;
+    std::mt19937 rng(7);
+    for (int step = 0; step < 50000; step++) {
+        int key = static_cast<int>(rng() % 3000);
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(map->remove(key), reference.erase(key) == 1);
+        } else {
+            map->put(key, step);
+            reference[key] = step;
+        }
+    }
+    EXPECT_EQ(map->size(), reference.size());
+    for (const auto& [key, value] : reference) {
+        EXPECT_EQ(map->get(key), value);
+    }
+}
+
+TEST_F(ConcurrentCuckooHashMapTest, ParallelInserts) {
+    const int threads = 8;
+    const int perThread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([this, t]() {
+            for (int i = 0; i < perThread; i++) {
+                map->put(t * perThread + i, i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(map->size(), static_cast<size_t>(threads * perThread));
+    for (int key = 0; key < threads * perThread; key++) {
+        EXPECT_EQ(map->get(key), key % perThread);
+    }
+}
+
+TEST_F(ConcurrentCuckooHashMapTest, ReadersDuringDisplacementAndGrowth) {
+    // Ключи 0..999 не удаляются; писатели вставляют новые ключи (вытеснения
+    // и рост таблицы), удаляют часть из них и обновляют значения старых
+    for (int i = 0; i < 1000; i++) {
+        map->put(i, i);
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<int> wrongReads{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([this, &stop, &wrongReads]() {
+            while (!stop.load()) {
+                for (int i = 0; i < 1000; i++) {
+                    int value;
+                    if (!map->tryGet(i, value) || value % 1000 != i) {
+                        wrongReads++;
+                    }
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; t++) {
+        writers.emplace_back([this, t]() {
+            for (int i = 0; i < 20000; i++) {
+                int key = 1000 + t * 20000 + i;
+                map->put(key, key);
+                if (i % 2 == 0) map->remove(key);
+                map->put(i % 1000, i % 1000 + 1000);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(wrongReads.load(), 0);
+    EXPECT_EQ(map->size(), 1000u + 2 * 10000u);
+}
+
+struct ConstantHash {
+    size_t operator()(int) const {
+        return 7;
+    }
+};
+
+TEST_F(ConcurrentCuckooHashMapTest, DegenerateHashThrows) {
+    ConcurrentCuckooHashMap<int, int, ConstantHash> degenerate;
+    for (int i = 0; i < 8; i++) {
+        degenerate.put(i, i);
+    }
+    EXPECT_THROW(degenerate.put(8, 8), std::runtime_error);
+    EXPECT_EQ(degenerate.size(), 8);
+    EXPECT_EQ(degenerate.get(5), 5);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "../src/containers/hash.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class ConcurrentHashMapTest : public ::testing::Test {
+protected:
+    ConcurrentHashMap<int, int>* map;
+
+    void SetUp() override {
+        map = new ConcurrentHashMap<int, int>(16);
+    }
+
+    void TearDown() override {
+        delete map;
+    }
+};
+
+TEST_F(ConcurrentHashMapTest, DefaultConstructor) {
+    EXPECT_TRUE(map->empty());
+    EXPECT_EQ(map->size(), 0);
+    EXPECT_EQ(map->shardCount(), 16);
+    ConcurrentHashMap<int, int> rounded(10);
+    EXPECT_EQ(rounded.shardCount(), 16);
+}
+
+TEST_F(ConcurrentHashMapTest, SingleThreadOperations) {
+    map->put(1, 10);
+    map->put(2, 20);
+    map->put(1, 11);
+    EXPECT_EQ(map->size(), 2);
+    EXPECT_EQ(map->get(1), 11);
+    int value = 0;
+    EXPECT_TRUE(map->tryGet(2, value));
+    EXPECT_EQ(value, 20);
+    EXPECT_FALSE(map->tryGet(3, value));
+    EXPECT_THROW(map->get(3), std::runtime_error);
+    EXPECT_TRUE(map->remove(1));
+    EXPECT_FALSE(map->contains(1));
+    map->clear();
+    EXPECT_TRUE(map->empty());
+}
+
+TEST_F(ConcurrentHashMapTest, ParallelInserts) {
+    const int threads = 8;
+    const int perThread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([this, t]() {
+            for (int i = 0; i < perThread; i++) {
+                map->put(t * perThread + i, i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(map->size(), static_cast<size_t>(threads * perThread));
+    for (int key = 0; key < threads * perThread; key++) {
+        EXPECT_EQ(map->get(key), key % perThread);
+    }
+}
+
+TEST_F(ConcurrentHashMapTest, ReadersAndWriters) {
+    for (int i = 0; i < 1000; i++) {
+        map->put(i, i);
+    }
+    std::vector<std::thread> workers;
+    std::atomic<int> wrongReads{0};
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([this, &wrongReads]() {
+            for (int round = 0; round < 20; round++) {
+                for (int i = 0; i < 1000; i++) {
+                    int value;
+                    // Ключи 0..999 не удаляются, значения только растут на 1000
+                    if (!map->tryGet(i, value) || value % 1000 != i) {
+                        wrongReads++;
+                    }
+                }
+            }
+        });
+    }
+    for (int t = 0; t < 2; t++) {
+        workers.emplace_back([this, t]() {
+            for (int i = 0; i < 20000; i++) {
+                int key = 1000 + t * 20000 + i;
+                map->put(key, key);
+                if (i % 2 == 0) map->remove(key);
+                map->put(i % 1000, i % 1000 + 1000);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(wrongReads.load(), 0);
+    EXPECT_EQ(map->size(), 1000u + 2 * 10000u);
+}
+
+TEST_F(ConcurrentHashMapTest, StringKeys) {
+    ConcurrentHashMap<std::string, std::string> strings(4, 1000);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&strings, t]() {
+            for (int i = 0; i < 500; i++) {
+                strings.put("t" + std::to_string(t) + "_" + std::to_string(i), std::to_string(i));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(strings.size(), 2000);
+    EXPECT_EQ(strings.get("t3_499"), "499");
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../src/containers/hash.h"
+#include <iterator>
 #include <sstream>
 
 class CuckooHashMapTest : public ::testing::Test {
@@ -85,3 +86,187 @@ TEST_F(CuckooHashMapTest, CollisionHandling) {
         EXPECT_EQ(map->get("key" + std::to_string(i)), i);
     }
 }
+
+TEST_F(CuckooHashMapTest, GrowsBeyondInitialCapacity) {
+    // Раньше put() бросал исключение после 2 * capacity элементов
+    CuckooHashMap<int, int> ints(4);
+    for (int i = 0; i < 100000; i++) {
+        ints.put(i, i * 2);
+    }
+    EXPECT_EQ(ints.size(), 100000);
+    EXPECT_LE(ints.loadFactor(), 0.5);
+    for (int i = 0; i < 100000; i++) {
+        EXPECT_EQ(ints.get(i), i * 2);
+    }
+}
+
+TEST_F(CuckooHashMapTest, RemoveAndReinsertMany) {
+    CuckooHashMap<int, int> ints;
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 1000; i++) {
+            ints.put(round * 1000 + i, i);
+        }
+        for (int i = 0; i < 1000; i += 2) {
+            EXPECT_TRUE(ints.remove(round * 1000 + i));
+        }
+    }
+    EXPECT_EQ(ints.size(), 20 * 500);
+    for (int key = 0; key < 20000; key++) {
+        EXPECT_EQ(ints.contains(key), key % 2 == 1);
+    }
+}
+
+struct CollidingHash {
+    size_t operator()(int key) const {
+        // Пары ключей с одинаковым полным хешем
+        return static_cast<size_t>(key / 2);
+    }
+};
+
+TEST_F(CuckooHashMapTest, IdenticalHashesUseStash) {
+    CuckooHashMap<int, int, CollidingHash> colliding;
+    for (int i = 0; i < 6; i++) {
+        colliding.put(i, i);
+    }
+    // Три ключа с одним хешем: в таблицах для них два слота, третий - в стэше
+    colliding.put(100, 100);
+    colliding.put(101, 101);
+    colliding.put(200, 200);
+    colliding.put(201, 201);
+    for (int key : {0, 1, 2, 3, 4, 5, 100, 101, 200, 201}) {
+        EXPECT_EQ(colliding.get(key), key);
+    }
+    EXPECT_EQ(colliding.size(), 10);
+}
+
+struct ConstantHash {
+    size_t operator()(int) const {
+        return 7;
+    }
+};
+
+TEST_F(CuckooHashMapTest, DegenerateHashStaysCorrect) {
+    // Никакие seed'ы не разделят одинаковые хеши: лишние элементы
+    // остаются в стэше, но ничего не теряется
+    CuckooHashMap<int, int, ConstantHash> degenerate(8);
+    for (int i = 0; i < 20; i++) {
+        degenerate.put(i, i);
+    }
+    EXPECT_EQ(degenerate.size(), 20);
+    EXPECT_GE(degenerate.stashSize(), 18u);
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(degenerate.get(i), i);
+    }
+    EXPECT_TRUE(degenerate.remove(0));
+    EXPECT_TRUE(degenerate.remove(19));
+    EXPECT_EQ(degenerate.size(), 18);
+    for (int i = 1; i < 19; i++) {
+        EXPECT_TRUE(degenerate.contains(i));
+    }
+}
+
+TEST_F(CuckooHashMapTest, SeededHashDependsOnSeedAndEveryByte) {
+    SeededHash<std::string> hasher;
+    EXPECT_EQ(hasher("cuckoo", 1), hasher("cuckoo", 1));
+    EXPECT_NE(hasher("cuckoo", 1), hasher("cuckoo", 2));
+
+    // Все длины, включая границы веток 3/4, 16/17 и 48/49 байт
+    std::string text(100, 'a');
+    for (size_t len = 0; len <= text.size(); len++) {
+        std::string_view prefix(text.data(), len);
+        Hash128 base = hasher(prefix, 0);
+        EXPECT_NE(base.first, base.second);
+        if (len > 0) {
+            std::string changed(prefix);
+            changed[len / 2] = 'b';
+            EXPECT_NE(hasher(changed, 0), base) << "len " << len;
+        }
+        if (len < text.size()) {
+            EXPECT_NE(hasher(std::string_view(text.data(), len + 1), 0), base);
+        }
+    }
+}
+
+TEST_F(CuckooHashMapTest, SeededHashHalvesAreIndependent) {
+    // Для коррелированных позиций (h % n, h / n % n) пары совпадали бы
+    // для всех ключей с одинаковым h % n
+    SeededHash<int> hasher;
+    const uint64_t n = 64;
+    std::vector<int> sameFirst(n, 0);
+    int pairs = 0;
+    for (int key = 0; key < 100000; key++) {
+        Hash128 h = hasher(key, 42);
+        if (h.first % n == 0) {
+            sameFirst[h.second % n]++;
+            pairs++;
+        }
+    }
+    // При фиксированной первой позиции вторая распределена равномерно
+    for (uint64_t i = 0; i < n; i++) {
+        EXPECT_GT(sameFirst[i], pairs / static_cast<int>(n) / 2);
+        EXPECT_LT(sameFirst[i], pairs / static_cast<int>(n) * 2);
+    }
+}
+
+TEST_F(CuckooHashMapTest, BinarySerialization) {
+    CuckooHashMap<int, int, ConstantHash> degenerate(8);
+    for (int i = 0; i < 6; i++) {
+        degenerate.put(i, i * 10);
+    }
+    CuckooHashMap<std::string, std::string> strings;
+    for (int i = 0; i < 500; i++) {
+        strings.put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+
+    // Сохраняются и элементы стэша
+    std::ofstream out("test_cuckoo.bin", std::ios::binary);
+    degenerate.saveToBinary(out);
+    strings.saveToBinary(out);
+    out.close();
+
+    CuckooHashMap<int, int, ConstantHash> degenerateLoaded;
+    CuckooHashMap<std::string, std::string> stringsLoaded;
+    std::ifstream in("test_cuckoo.bin", std::ios::binary);
+    degenerateLoaded.loadFromBinary(in);
+    stringsLoaded.loadFromBinary(in);
+    in.close();
+
+    EXPECT_EQ(degenerateLoaded.size(), 6);
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ(degenerateLoaded.get(i), i * 10);
+    }
+    EXPECT_EQ(stringsLoaded.size(), 500);
+    EXPECT_EQ(stringsLoaded.get("key499"), "value499");
+
+    std::remove("test_cuckoo.bin");
+}
+
+TEST_F(CuckooHashMapTest, TruncatedSnapshotThrows) {
+    CuckooHashMap<std::string, std::string> strings;
+    for (int i = 0; i < 3; i++) {
+        strings.put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    std::ofstream out("test_cuckoo_bad.bin", std::ios::binary);
+    strings.saveToBinary(out);
+    out.close();
+    std::ifstream whole("test_cuckoo_bad.bin", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(whole)), std::istreambuf_iterator<char>());
+    whole.close();
+
+    // Заголовок короче 4 байт, обрезанное тело, огромное число элементов
+    std::string hugeCount = "\xF0\xFF\xFF\xFF";
+    for (const std::string& broken : {bytes.substr(0, 2), bytes.substr(0, bytes.size() - 6), hugeCount}) {
+        std::ofstream cut("test_cuckoo_bad.bin", std::ios::binary | std::ios::trunc);
+        cut.write(broken.data(), static_cast<std::streamsize>(broken.size()));
+        cut.close();
+
+        CuckooHashMap<std::string, std::string> loaded;
+        loaded.put("stale", "value");
+        std::ifstream in("test_cuckoo_bad.bin", std::ios::binary);
+        EXPECT_THROW(loaded.loadFromBinary(in), std::runtime_error);
+        in.close();
+        EXPECT_TRUE(loaded.empty());
+    }
+
+    std::remove("test_cuckoo_bad.bin");
+}
@@ -1,7 +1,27 @@
 #include <gtest/gtest.h>
 #include "../src/containers/hash.h"
+#include <iterator>
 #include <sstream>
 
+// Ключ, считающий вызовы std::hash: проверяет, что ключ хешируется
+// один раз за операцию и что рост таблицы не хеширует ключи заново
+struct CountedKey {
+    int id;
+    static size_t hashCalls;
+    bool operator==(const CountedKey& other) const { return id == other.id; }
+};
+size_t CountedKey::hashCalls = 0;
+
+namespace std {
+template<>
+struct hash<CountedKey> {
+    size_t operator()(const CountedKey& key) const {
+        CountedKey::hashCalls++;
+        return std::hash<int>()(key.id);
+    }
+};
+}
+
 class HashMapTest : public ::testing::Test {
 protected:
     HashMap<std::string, std::string>* map;
@@ -153,3 +173,353 @@ TEST_F(HashMapTest, IntegerHashMap) {
     EXPECT_EQ(intMap.get(2), 200);
     EXPECT_EQ(intMap.get(3), 300);
 }
+
+TEST_F(HashMapTest, GrowsBeyondInitialCapacity) {
+    size_t initial = map->bucketCount();
+    for (int i = 0; i < 10000; i++) {
+        map->put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    
+    EXPECT_EQ(map->size(), 10000);
+    EXPECT_GT(map->bucketCount(), initial);
+    EXPECT_LE(map->loadFactor(), map->maxLoadFactor());
+    for (int i = 0; i < 10000; i++) {
+        EXPECT_EQ(map->get("key" + std::to_string(i)), "value" + std::to_string(i));
+    }
+}
+
+TEST_F(HashMapTest, ReserveAndShrinkToFit) {
+    map->reserve(1000);
+    size_t reserved = map->bucketCount();
+    EXPECT_GE(reserved * map->maxLoadFactor(), 1000);
+    
+    for (int i = 0; i < 1000; i++) {
+        map->put("key" + std::to_string(i), "value");
+    }
+    EXPECT_EQ(map->bucketCount(), reserved);
+    
+    map->clear();
+    for (int i = 0; i < 10; i++) {
+        map->put("key" + std::to_string(i), "value");
+    }
+    map->shrink_to_fit();
+    EXPECT_LT(map->bucketCount(), reserved);
+    EXPECT_EQ(map->size(), 10);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(map->contains("key" + std::to_string(i)));
+    }
+}
+
+TEST_F(HashMapTest, MaxLoadFactor) {
+    HashMap<int, int> dense(11, 0.5);
+    EXPECT_DOUBLE_EQ(dense.maxLoadFactor(), 0.5);
+    for (int i = 0; i < 100; i++) {
+        dense.put(i, i);
+    }
+    EXPECT_LE(dense.loadFactor(), 0.5);
+    
+    EXPECT_THROW(dense.setMaxLoadFactor(0.0), std::invalid_argument);
+    EXPECT_THROW(dense.setMaxLoadFactor(1.5), std::invalid_argument);
+}
+
+TEST_F(HashMapTest, IncrementalRehash) {
+    HashMap<std::string, std::string> inc(11, 0.75, HashMap<std::string, std::string>::INCREMENTAL_REHASH);
+    bool sawRehashing = false;
+    for (int i = 0; i < 5000; i++) {
+        inc.put("key" + std::to_string(i), "value" + std::to_string(i));
+        sawRehashing = sawRehashing || inc.isRehashing();
+        // Ключи доступны как из новой, так и из ещё не перенесённой таблицы
+        EXPECT_TRUE(inc.contains("key" + std::to_string(i / 2)));
+    }
+    EXPECT_TRUE(sawRehashing);
+    EXPECT_EQ(inc.size(), 5000);
+    
+    inc.put("key7", "updated");
+    EXPECT_EQ(inc.get("key7"), "updated");
+    EXPECT_TRUE(inc.remove("key7"));
+    EXPECT_FALSE(inc.contains("key7"));
+    EXPECT_EQ(inc.size(), 4999);
+    
+    inc.setRehashMode(HashMap<std::string, std::string>::FULL_REHASH);
+    EXPECT_FALSE(inc.isRehashing());
+    for (int i = 0; i < 5000; i++) {
+        if (i == 7) continue;
+        EXPECT_EQ(inc.get("key" + std::to_string(i)), "value" + std::to_string(i));
+    }
+}
+
+TEST_F(HashMapTest, TruncatedSnapshotThrows) {
+    // Файл короче заголовка с числом элементов
+    std::ofstream out("test_hashmap_bad.bin", std::ios::binary);
+    out.write("\x01\x00", 2);
+    out.close();
+    
+    HashMap<std::string, std::string> loaded;
+    loaded.put("stale", "value");
+    std::ifstream in("test_hashmap_bad.bin", std::ios::binary);
+    EXPECT_THROW(loaded.loadFromBinary(in), std::runtime_error);
+    in.close();
+    EXPECT_TRUE(loaded.empty());
+    
+    // Обрезанное тело: заголовок цел, последней пары не хватает 6 байт
+    map->put("key1", "value1");
+    map->put("key2", "value2");
+    map->put("key3", "value3");
+    std::ofstream full("test_hashmap_bad.bin", std::ios::binary);
+    map->saveToBinary(full);
+    full.close();
+    std::ifstream whole("test_hashmap_bad.bin", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(whole)), std::istreambuf_iterator<char>());
+    whole.close();
+    std::ofstream cut("test_hashmap_bad.bin", std::ios::binary | std::ios::trunc);
+    cut.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 6));
+    cut.close();
+    std::ifstream body("test_hashmap_bad.bin", std::ios::binary);
+    EXPECT_THROW(loaded.loadFromBinary(body), std::runtime_error);
+    body.close();
+    EXPECT_TRUE(loaded.empty());
+    
+    // Огромное число элементов в заголовке без данных
+    std::ofstream huge("test_hashmap_bad.bin", std::ios::binary | std::ios::trunc);
+    writeBinary(huge, uint32_t(0xFFFFFFF0));
+    huge.close();
+    std::ifstream hugeIn("test_hashmap_bad.bin", std::ios::binary);
+    EXPECT_THROW(loaded.loadFromBinary(hugeIn), std::runtime_error);
+    hugeIn.close();
+    EXPECT_TRUE(loaded.empty());
+    
+    // Строка с длиной 4 ГБ и без данных
+    std::ofstream longKey("test_hashmap_bad.bin", std::ios::binary | std::ios::trunc);
+    writeBinary(longKey, uint32_t(1));
+    writeBinary(longKey, uint32_t(0xFFFFFFFF));
+    longKey.close();
+    std::ifstream longKeyIn("test_hashmap_bad.bin", std::ios::binary);
+    EXPECT_THROW(loaded.loadFromBinary(longKeyIn), std::runtime_error);
+    longKeyIn.close();
+    
+    std::remove("test_hashmap_bad.bin");
+}
+
+TEST_F(HashMapTest, IncrementalRehashBinarySerialization) {
+    HashMap<std::string, std::string> inc(11, 0.75, HashMap<std::string, std::string>::INCREMENTAL_REHASH);
+    int n = 0;
+    while (!inc.isRehashing() || n < 20) {
+        inc.put("key" + std::to_string(n), "value" + std::to_string(n));
+        n++;
+    }
+    
+    std::ofstream out("test_hashmap_inc.bin", std::ios::binary);
+    inc.saveToBinary(out);
+    out.close();
+    
+    HashMap<std::string, std::string> loaded;
+    std::ifstream in("test_hashmap_inc.bin", std::ios::binary);
+    loaded.loadFromBinary(in);
+    in.close();
+    
+    EXPECT_EQ(loaded.size(), static_cast<size_t>(n));
+    for (int i = 0; i < n; i++) {
+        EXPECT_EQ(loaded.get("key" + std::to_string(i)), "value" + std::to_string(i));
+    }
+    std::remove("test_hashmap_inc.bin");
+}
+
+TEST_F(HashMapTest, RemoveKeepsProbeChains) {
+    // Удаление не должно разрывать цепочки проб других ключей
+    for (int i = 0; i < 2000; i++) {
+        map->put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    for (int i = 0; i < 2000; i += 2) {
+        EXPECT_TRUE(map->remove("key" + std::to_string(i)));
+    }
+    EXPECT_EQ(map->size(), 1000);
+    for (int i = 0; i < 2000; i++) {
+        EXPECT_EQ(map->contains("key" + std::to_string(i)), i % 2 == 1);
+    }
+}
+
+TEST_F(HashMapTest, ChurnKeepsProbeDistanceBounded) {
+    HashMap<int, int> churn(101, 0.9);
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 80; i++) {
+            churn.put(round * 1000 + i, i);
+        }
+        for (int i = 0; i < 80; i++) {
+            if (i % 4 != 0) {
+                EXPECT_TRUE(churn.remove(round * 1000 + i));
+            }
+        }
+    }
+    EXPECT_EQ(churn.size(), 50u * 20u);
+    EXPECT_LE(churn.maxProbeDistance(), 32u);
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 80; i++) {
+            EXPECT_EQ(churn.contains(round * 1000 + i), i % 4 == 0);
+        }
+    }
+}
+
+TEST_F(HashMapTest, IncrementalRehashWithRemovals) {
+    HashMap<int, int> inc(11, 0.75, HashMap<int, int>::INCREMENTAL_REHASH);
+    for (int i = 0; i < 3000; i++) {
+        inc.put(i, i);
+        if (i % 3 == 0) {
+            EXPECT_TRUE(inc.remove(i / 2));
+            inc.put(i / 2, i / 2);
+        }
+    }
+    EXPECT_EQ(inc.size(), 3000);
+    for (int i = 0; i < 3000; i++) {
+        EXPECT_EQ(inc.get(i), i);
+    }
+}
+
+TEST_F(HashMapTest, HashesEachKeyOncePerOperation) {
+    for (auto rehashMode : {HashMap<CountedKey, int>::FULL_REHASH, HashMap<CountedKey, int>::INCREMENTAL_REHASH}) {
+        HashMap<CountedKey, int> counted(11, 0.75, rehashMode);
+        CountedKey::hashCalls = 0;
+        for (int i = 0; i < 1000; i++) {
+            counted.put(CountedKey{i}, i);
+        }
+        // Несколько ростов таблицы не добавили вызовов хеш-функции
+        EXPECT_EQ(CountedKey::hashCalls, 1000u);
+        
+        CountedKey::hashCalls = 0;
+        EXPECT_EQ(counted.get(CountedKey{500}), 500);
+        EXPECT_TRUE(counted.contains(CountedKey{1}));
+        EXPECT_TRUE(counted.remove(CountedKey{2}));
+        EXPECT_EQ(CountedKey::hashCalls, 3u);
+    }
+}
+
+TEST_F(HashMapTest, IntegerKeyPreset) {
+    IntegerKeyHashMap<int, int> ints(10);
+    // Ёмкость - степень двойки
+    EXPECT_EQ(ints.bucketCount() & (ints.bucketCount() - 1), 0u);
+    for (int i = 0; i < 5000; i++) {
+        ints.put(i * 64, i);
+    }
+    EXPECT_EQ(ints.bucketCount() & (ints.bucketCount() - 1), 0u);
+    for (int i = 0; i < 5000; i += 2) {
+        EXPECT_TRUE(ints.remove(i * 64));
+    }
+    EXPECT_EQ(ints.size(), 2500);
+    for (int i = 0; i < 5000; i++) {
+        EXPECT_EQ(ints.contains(i * 64), i % 2 == 1);
+    }
+}
+
+TEST_F(HashMapTest, StringKeyPreset) {
+    StringKeyHashMap<std::string> strings;
+    for (int i = 0; i < 1000; i++) {
+        strings.put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    EXPECT_TRUE(strings.remove("key10"));
+    EXPECT_FALSE(strings.contains("key10"));
+    EXPECT_EQ(strings.get("key999"), "value999");
+    
+    const std::string filename = "test_hashmap_preset.bin";
+    {
+        std::ofstream out(filename, std::ios::binary);
+        strings.saveToBinary(out);
+    }
+    // Формат файла не зависит от стратегий
+    HashMap<std::string, std::string> loaded;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        loaded.loadFromBinary(in);
+    }
+    std::remove(filename.c_str());
+    EXPECT_EQ(loaded.size(), 999);
+    EXPECT_EQ(loaded.get("key500"), "value500");
+}
+
+TEST_F(HashMapTest, LinearProbingChurn) {
+    // Без Robin Hood удаление сдвигает только элементы, чей домашний
+    // слот не позже освободившегося
+    HashMap<int, int, IntegerHash, std::equal_to<int>, LinearProbing, PowerOfTwoReduction> linear(16, 0.9);
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 100; i++) {
+            linear.put(round * 1000 + i, i);
+        }
+        for (int i = 0; i < 100; i++) {
+            if (i % 5 != 0) {
+                EXPECT_TRUE(linear.remove(round * 1000 + i));
+            }
+        }
+    }
+    EXPECT_EQ(linear.size(), 50 * 20);
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 100; i++) {
+            EXPECT_EQ(linear.contains(round * 1000 + i), i % 5 == 0);
+        }
+    }
+}
+
+TEST_F(HashMapTest, HeterogeneousLookup) {
+    map->put("alpha", "1");
+    map->put("beta", "2");
+    
+    std::string buffer = "HGET m alpha beta gamma";
+    std::string_view alpha = std::string_view(buffer).substr(7, 5);
+    std::string_view gamma = std::string_view(buffer).substr(18, 5);
+    EXPECT_TRUE(map->contains(alpha));
+    EXPECT_FALSE(map->contains(gamma));
+    EXPECT_TRUE(map->contains("beta"));
+    
+    const std::string* value = map->find(alpha);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, "1");
+    EXPECT_EQ(map->find(gamma), nullptr);
+    
+    // Неконстантный find позволяет менять значение на месте
+    *map->find(std::string("beta")) = "22";
+    EXPECT_EQ(map->get("beta"), "22");
+}
+
+TEST_F(HashMapTest, HeterogeneousLookupDuringIncrementalRehash) {
+    HashMap<std::string, int> inc(3, 0.75, HashMap<std::string, int>::INCREMENTAL_REHASH);
+    for (int i = 0; i < 500; i++) {
+        inc.put("k" + std::to_string(i), i);
+        std::string probe = "k" + std::to_string(i / 2);
+        const int* found = inc.find(std::string_view(probe));
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(*found, i / 2);
+    }
+}
+
+TEST_F(HashMapTest, GetManyAndPutMany) {
+    std::vector<std::pair<std::string, std::string>> items;
+    for (int i = 0; i < 100; i++) {
+        items.emplace_back("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    items.emplace_back("key7", "updated");
+    map->putMany(items);
+    EXPECT_EQ(map->size(), 100);
+    
+    std::vector<std::string_view> keys = {"key0", "missing", "key7", "key99"};
+    std::vector<const std::string*> values = map->getMany(keys);
+    ASSERT_EQ(values.size(), 4u);
+    ASSERT_NE(values[0], nullptr);
+    EXPECT_EQ(*values[0], "value0");
+    EXPECT_EQ(values[1], nullptr);
+    EXPECT_EQ(*values[2], "updated");
+    EXPECT_EQ(*values[3], "value99");
+}
+
+TEST_F(HashMapTest, PutManyDuringIncrementalRehash) {
+    HashMap<int, int> inc(3, 0.75, HashMap<int, int>::INCREMENTAL_REHASH);
+    std::vector<std::pair<int, int>> items;
+    std::vector<int> keys;
+    for (int i = 0; i < 2000; i++) {
+        items.emplace_back(i, i * 2);
+        keys.push_back(i);
+    }
+    inc.putMany(items);
+    EXPECT_EQ(inc.size(), 2000);
+    std::vector<const int*> values = inc.getMany(keys);
+    for (int i = 0; i < 2000; i++) {
+        ASSERT_NE(values[i], nullptr);
+        EXPECT_EQ(*values[i], i * 2);
+    }
+}
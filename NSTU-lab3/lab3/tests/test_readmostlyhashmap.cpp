@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "../src/containers/hash.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class ReadMostlyHashMapTest : public ::testing::Test {
+protected:
+    ReadMostlyHashMap<int, int>* map;
+
+    void SetUp() override {
+        map = new ReadMostlyHashMap<int, int>();
+    }
+
+    void TearDown() override {
+        delete map;
+    }
+};
+
+TEST_F(ReadMostlyHashMapTest, DefaultConstructor) {
+    EXPECT_TRUE(map->empty());
+    EXPECT_EQ(map->size(), 0);
+    EXPECT_EQ(map->bucketCount(), 64);
+}
+
+TEST_F(ReadMostlyHashMapTest, PutGetRemove) {
+    map->put(1, 10);
+    map->put(2, 20);
+    map->put(1, 11);
+    EXPECT_EQ(map->size(), 2);
+    EXPECT_EQ(map->get(1), 11);
+    EXPECT_TRUE(map->contains(2));
+    EXPECT_THROW(map->get(3), std::runtime_error);
+    EXPECT_TRUE(map->remove(2));
+    EXPECT_FALSE(map->remove(2));
+    EXPECT_FALSE(map->contains(2));
+    EXPECT_EQ(map->size(), 1);
+}
+
+TEST_F(ReadMostlyHashMapTest, GrowsAndClears) {
+    for (int i = 0; i < 10000; i++) {
+        map->put(i, i * 3);
+    }
+    EXPECT_EQ(map->size(), 10000);
+    EXPECT_GE(map->bucketCount(), 10000);
+    for (int i = 0; i < 10000; i++) {
+        EXPECT_EQ(map->get(i), i * 3);
+    }
+    map->clear();
+    EXPECT_TRUE(map->empty());
+    EXPECT_FALSE(map->contains(5));
+}
+
+TEST_F(ReadMostlyHashMapTest, ReclaimsWithoutReaders) {
+    for (int i = 0; i < 1000; i++) {
+        map->put(i % 10, i);
+    }
+    // Активных читателей нет - все старые версии уже освобождены
+    EXPECT_EQ(map->pendingReclamation(), 0);
+}
+
+TEST_F(ReadMostlyHashMapTest, ReaderBlocksReclamation) {
+    map->put(1, 1);
+    {
+        EpochGuard reader;
+        map->put(1, 2);
+        // Читатель мог видеть старую цепочку - её нельзя освобождать
+        EXPECT_GT(map->pendingReclamation(), 0);
+    }
+    EXPECT_EQ(map->pendingReclamation(), 0);
+    EXPECT_EQ(map->get(1), 2);
+}
+
+TEST_F(ReadMostlyHashMapTest, ConcurrentReadersWithWriter) {
+    for (int i = 0; i < 1000; i++) {
+        map->put(i, i);
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<int> wrongReads{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([this, &stop, &wrongReads]() {
+            while (!stop.load()) {
+                for (int i = 0; i < 1000; i++) {
+                    int value;
+                    if (!map->tryGet(i, value) || value % 1000 != i) {
+                        wrongReads++;
+                    }
+                }
+            }
+        });
+    }
+    // Писатель обновляет значения и добавляет ключи, вызывая рост таблицы
+    for (int round = 1; round <= 20; round++) {
+        for (int i = 0; i < 1000; i++) {
+            map->put(i, round * 1000 + i);
+        }
+        for (int i = 0; i < 500; i++) {
+            map->put(round * 100000 + i, 0);
+        }
+    }
+    stop.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(wrongReads.load(), 0);
+    EXPECT_EQ(map->size(), 1000u + 20 * 500u);
+    EXPECT_EQ(map->pendingReclamation(), 0);
+}
+
+TEST_F(ReadMostlyHashMapTest, StringValues) {
+    ReadMostlyHashMap<std::string, std::string> strings;
+    strings.put("name", "John");
+    strings.put("city", "Novosibirsk");
+    EXPECT_EQ(strings.get("name"), "John");
+    strings.put("name", "Jane");
+    EXPECT_EQ(strings.get("name"), "Jane");
+    EXPECT_EQ(strings.size(), 2);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "../src/containers/hash.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+
+class RoaringSetTest : public ::testing::Test {
+protected:
+    RoaringSet<uint32_t> set;
+
+    static std::vector<uint32_t> elements(const RoaringSet<uint32_t>& s) {
+        std::vector<uint32_t> values;
+        s.forEach([&values](uint32_t value) { values.push_back(value); });
+        return values;
+    }
+};
+
+TEST_F(RoaringSetTest, EmptyByDefault) {
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(set.size(), 0u);
+    EXPECT_FALSE(set.contains(0));
+}
+
+TEST_F(RoaringSetTest, AddContainsRemove) {
+    set.add(7);
+    set.add(70000);
+    set.add(7);
+    EXPECT_EQ(set.size(), 2u);
+    EXPECT_TRUE(set.contains(7));
+    EXPECT_TRUE(set.contains(70000));
+    EXPECT_FALSE(set.contains(8));
+
+    EXPECT_TRUE(set.remove(7));
+    EXPECT_FALSE(set.remove(7));
+    EXPECT_FALSE(set.contains(7));
+    EXPECT_EQ(set.size(), 1u);
+}
+
+TEST_F(RoaringSetTest, ArrayBecomesBitmapAndBack) {
+    // Больше 4096 элементов в блоке - битовая карта на 8 КБ
+    for (uint32_t i = 0; i < 20000; i += 2) {
+        set.add(i);
+    }
+    EXPECT_EQ(set.size(), 10000u);
+    EXPECT_LT(set.memoryUsage(), 8192u + 256u);
+    for (uint32_t i = 0; i < 20000; i++) {
+        EXPECT_EQ(set.contains(i), i % 2 == 0);
+    }
+
+    for (uint32_t i = 0; i < 19000; i += 2) {
+        set.remove(i);
+    }
+    EXPECT_EQ(set.size(), 500u);
+    EXPECT_TRUE(set.contains(19998));
+    EXPECT_FALSE(set.contains(18998));
+}
+
+TEST_F(RoaringSetTest, AddRangeStoresRuns) {
+    set.addRange(5, 999999);
+    EXPECT_EQ(set.size(), 999995u);
+    EXPECT_FALSE(set.contains(4));
+    EXPECT_TRUE(set.contains(5));
+    EXPECT_TRUE(set.contains(65536));
+    EXPECT_TRUE(set.contains(999999));
+    EXPECT_FALSE(set.contains(1000000));
+    // 16 блоков по одному отрезку
+    EXPECT_LT(set.memoryUsage(), 2048u);
+
+    set.addRange(0, 10);
+    EXPECT_EQ(set.size(), 1000000u);
+}
+
+TEST_F(RoaringSetTest, RemoveSplitsRun) {
+    set.addRange(10, 20);
+    EXPECT_TRUE(set.remove(15));
+    EXPECT_TRUE(set.remove(10));
+    EXPECT_TRUE(set.remove(20));
+    EXPECT_EQ(elements(set), (std::vector<uint32_t>{11, 12, 13, 14, 16, 17, 18, 19}));
+    set.add(15);
+    set.add(10);
+    EXPECT_EQ(set.size(), 10u);
+}
+
+TEST_F(RoaringSetTest, OptimizeConvertsDenseBlocks) {
+    for (uint32_t i = 0; i < 100000; i++) {
+        set.add(i);
+    }
+    size_t before = set.memoryUsage();
+    set.optimize();
+    EXPECT_LT(set.memoryUsage() * 10, before);
+    EXPECT_EQ(set.size(), 100000u);
+    EXPECT_TRUE(set.contains(99999));
+    EXPECT_FALSE(set.contains(100000));
+}
+
+TEST_F(RoaringSetTest, SignedValuesKeepOrder) {
+    RoaringSet<int> numbers;
+    numbers.add(3);
+    numbers.add(-5);
+    numbers.add(-1);
+    numbers.addRange(-2, 1);
+    std::ostringstream oss;
+    numbers.print(oss);
+    EXPECT_EQ(oss.str(), "RoaringSet { -5, -2, -1, 0, 1, 3 } (size: 6)");
+    EXPECT_TRUE(numbers.contains(-2));
+    EXPECT_FALSE(numbers.contains(2));
+}
+
+TEST_F(RoaringSetTest, AlgebraMatchesStdSet) {
+    // Массивы, карты и отрезки во всех сочетаниях
+    std::mt19937 rng(42);
+    auto build = [&rng](RoaringSet<uint32_t>& target, std::set<uint32_t>& reference, int shape) {
+        for (uint32_t block = 0; block < 4; block++) {
+            uint32_t base = block << 16;
+            int kind = (shape + static_cast<int>(block)) % 3;
+            if (kind == 0) {
+                for (int i = 0; i < 300; i++) {
+                    uint32_t v = base + rng() % 65536;
+                    target.add(v);
+                    reference.insert(v);
+                }
+            } else if (kind == 1) {
+                for (int i = 0; i < 20000; i++) {
+                    uint32_t v = base + rng() % 65536;
+                    target.add(v);
+                    reference.insert(v);
+                }
+            } else {
+                for (int r = 0; r < 5; r++) {
+                    uint32_t first = base + rng() % 60000;
+                    uint32_t last = first + rng() % 5000;
+                    target.addRange(first, last);
+                    for (uint32_t v = first; v <= last; v++) reference.insert(v);
+                }
+            }
+        }
+    };
+
+    for (int shapeA = 0; shapeA < 3; shapeA++) {
+        for (int shapeB = 0; shapeB < 3; shapeB++) {
+            RoaringSet<uint32_t> a, b;
+            std::set<uint32_t> refA, refB;
+            build(a, refA, shapeA);
+            build(b, refB, shapeB);
+
+            std::vector<uint32_t> expected;
+            std::set_union(refA.begin(), refA.end(), refB.begin(), refB.end(), std::back_inserter(expected));
+            RoaringSet<uint32_t> united = RoaringSet<uint32_t>::unionOf(a, b);
+            EXPECT_EQ(elements(united), expected);
+            EXPECT_EQ(united.size(), expected.size());
+
+            expected.clear();
+            std::set_intersection(refA.begin(), refA.end(), refB.begin(), refB.end(), std::back_inserter(expected));
+            RoaringSet<uint32_t> common = RoaringSet<uint32_t>::intersectionOf(a, b);
+            EXPECT_EQ(elements(common), expected);
+            EXPECT_EQ(common.size(), expected.size());
+
+            expected.clear();
+            std::set_difference(refA.begin(), refA.end(), refB.begin(), refB.end(), std::back_inserter(expected));
+            RoaringSet<uint32_t> rest = RoaringSet<uint32_t>::differenceOf(a, b);
+            EXPECT_EQ(elements(rest), expected);
+            EXPECT_EQ(rest.size(), expected.size());
+        }
+    }
+}
+
+TEST_F(RoaringSetTest, DenseIdsMuchSmallerThanHashSet) {
+    Set<uint32_t> hashed;
+    for (uint32_t i = 0; i < 200000; i++) {
+        set.add(i);
+        hashed.add(i);
+    }
+    EXPECT_LT(set.memoryUsage() * 10, hashed.memoryUsage());
+}
@@ -80,3 +80,126 @@ TEST_F(SetTest, Print) {
     std::string output = oss.str();
     EXPECT_FALSE(output.empty());
 }
+
+TEST_F(SetTest, StringViewContains) {
+    Set<std::string> words;
+    words.add("apple");
+    words.add("pear");
+    std::string line = "ECONTAINS fruits apple plum";
+    EXPECT_TRUE(words.contains(std::string_view(line).substr(17, 5)));
+    EXPECT_FALSE(words.contains(std::string_view(line).substr(23, 4)));
+}
+
+TEST_F(SetTest, GrowsFromEmpty) {
+    for (int i = 0; i < 10000; i++) {
+        set->add(i * 3);
+    }
+    EXPECT_EQ(set->size(), 10000);
+    for (int i = 0; i < 30000; i++) {
+        EXPECT_EQ(set->contains(i), i % 3 == 0);
+    }
+}
+
+TEST_F(SetTest, RemoveAndReinsertReusesSlots) {
+    set->reserve(1000);
+    size_t capacity = set->bucketCount();
+    // Надгробия не должны заставлять таблицу расти бесконечно
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 500; i++) {
+            set->add(round * 1000 + i);
+        }
+        for (int i = 0; i < 500; i++) {
+            EXPECT_TRUE(set->remove(round * 1000 + i));
+        }
+    }
+    EXPECT_TRUE(set->empty());
+    EXPECT_EQ(set->bucketCount(), capacity);
+}
+
+TEST_F(SetTest, ForEachVisitsEveryElementOnce) {
+    for (int i = 0; i < 1000; i++) {
+        set->add(i);
+    }
+    set->remove(500);
+    long sum = 0;
+    size_t visited = 0;
+    set->forEach([&sum, &visited](int value) {
+        sum += value;
+        visited++;
+    });
+    EXPECT_EQ(visited, 999u);
+    EXPECT_EQ(sum, 999L * 1000 / 2 - 500);
+}
+
+TEST_F(SetTest, PrintListsElements) {
+    Set<std::string> words;
+    words.add("apple");
+    std::ostringstream oss;
+    words.print(oss);
+    EXPECT_EQ(oss.str(), "Set { apple } (size: 1)");
+}
+
+TEST_F(SetTest, CompactMemoryPerElement) {
+    // Байт метаданных и сам int на слот при заполненности не ниже 7/16
+    for (int i = 0; i < 100000; i++) {
+        set->add(i);
+    }
+    double perElement = static_cast<double>(set->memoryUsage()) / set->size();
+    EXPECT_LT(perElement, 12.0);
+    EXPECT_GE(perElement, sizeof(int) + 1.0);
+}
+
+TEST_F(SetTest, UnionIntersectionDifference) {
+    Set<int> other;
+    for (int i = 0; i < 10; i++) {
+        set->add(i);
+    }
+    for (int i = 5; i < 20; i++) {
+        other.add(i);
+    }
+
+    Set<int> united = Set<int>::unionOf(*set, other);
+    EXPECT_EQ(united.size(), 20u);
+    EXPECT_TRUE(united.contains(0));
+    EXPECT_TRUE(united.contains(19));
+
+    Set<int> common = Set<int>::intersectionOf(*set, other);
+    EXPECT_EQ(common.size(), 5u);
+    for (int i = 5; i < 10; i++) {
+        EXPECT_TRUE(common.contains(i));
+    }
+
+    Set<int> rest = Set<int>::differenceOf(*set, other);
+    EXPECT_EQ(rest.size(), 5u);
+    EXPECT_TRUE(rest.contains(0));
+    EXPECT_FALSE(rest.contains(5));
+    EXPECT_EQ(Set<int>::differenceOf(other, *set).size(), 10u);
+}
+
+TEST_F(SetTest, AlgebraWithEmptySet) {
+    Set<int> none;
+    set->add(1);
+    set->add(2);
+    EXPECT_EQ(Set<int>::unionOf(none, *set).size(), 2u);
+    EXPECT_TRUE(Set<int>::intersectionOf(*set, none).empty());
+    EXPECT_EQ(Set<int>::differenceOf(*set, none).size(), 2u);
+    EXPECT_TRUE(Set<int>::differenceOf(none, *set).empty());
+}
+
+TEST_F(SetTest, ParallelAlgebraMatchesSequential) {
+    // Явное число потоков включает разбиение и на одноядерной машине
+    Set<int> other;
+    for (int i = 0; i < 100000; i++) {
+        set->add(i);
+        other.add(i * 3);
+    }
+    for (size_t threads : {1u, 4u, 7u}) {
+        EXPECT_EQ(Set<int>::unionOf(*set, other, threads).size(), 100000u + 66666u);
+        EXPECT_EQ(Set<int>::intersectionOf(*set, other, threads).size(), 33334u);
+        EXPECT_EQ(Set<int>::differenceOf(*set, other, threads).size(), 100000u - 33334u);
+    }
+    Set<int> common = Set<int>::intersectionOf(*set, other, 4);
+    for (int i = 0; i < 100000; i += 3) {
+        EXPECT_TRUE(common.contains(i));
+    }
+}
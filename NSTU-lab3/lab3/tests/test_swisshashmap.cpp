@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "../src/containers/hash.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <string_view>
+
+class SwissHashMapTest : public ::testing::Test {
+protected:
+    SwissHashMap<std::string, std::string>* map;
+
+    void SetUp() override {
+        map = new SwissHashMap<std::string, std::string>();
+    }
+
+    void TearDown() override {
+        delete map;
+    }
+};
+
+TEST_F(SwissHashMapTest, DefaultConstructor) {
+    EXPECT_TRUE(map->empty());
+    EXPECT_EQ(map->size(), 0);
+    EXPECT_EQ(map->bucketCount() % ControlGroup::WIDTH, 0);
+}
+
+TEST_F(SwissHashMapTest, PutAndGet) {
+    map->put("key1", "value1");
+    EXPECT_EQ(map->size(), 1);
+    EXPECT_EQ(map->get("key1"), "value1");
+}
+
+TEST_F(SwissHashMapTest, UpdateValue) {
+    map->put("key", "a");
+    map->put("key", "b");
+    EXPECT_EQ(map->size(), 1);
+    EXPECT_EQ(map->get("key"), "b");
+}
+
+TEST_F(SwissHashMapTest, Contains) {
+    map->put("key1", "value1");
+    EXPECT_TRUE(map->contains("key1"));
+    EXPECT_FALSE(map->contains("key2"));
+}
+
+TEST_F(SwissHashMapTest, GetNonExistent) {
+    EXPECT_THROW(map->get("nonexistent"), std::runtime_error);
+}
+
+TEST_F(SwissHashMapTest, RemoveAndReinsert) {
+    map->put("key", "value1");
+    EXPECT_TRUE(map->remove("key"));
+    EXPECT_FALSE(map->remove("key"));
+    EXPECT_FALSE(map->contains("key"));
+    map->put("key", "value2");
+    EXPECT_EQ(map->get("key"), "value2");
+    EXPECT_EQ(map->size(), 1);
+}
+
+TEST_F(SwissHashMapTest, GrowsAndKeepsAllKeys) {
+    for (int i = 0; i < 10000; i++) {
+        map->put("key" + std::to_string(i), "value" + std::to_string(i));
+    }
+    EXPECT_EQ(map->size(), 10000);
+    EXPECT_GE(map->bucketCount(), 10000);
+    for (int i = 0; i < 10000; i++) {
+        EXPECT_EQ(map->get("key" + std::to_string(i)), "value" + std::to_string(i));
+    }
+}
+
+TEST_F(SwissHashMapTest, ChurnWithTombstones) {
+    SwissHashMap<int, int> churn(16);
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 50; i++) {
+            churn.put(round * 100 + i, i);
+        }
+        for (int i = 0; i < 50; i++) {
+            if (i % 5 != 0) {
+                EXPECT_TRUE(churn.remove(round * 100 + i));
+            }
+        }
+    }
+    EXPECT_EQ(churn.size(), 100u * 10u);
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 50; i++) {
+            EXPECT_EQ(churn.contains(round * 100 + i), i % 5 == 0);
+        }
+    }
+}
+
+struct CaseInsensitiveHash {
+    size_t operator()(const std::string& key) const {
+        size_t h = 0;
+        for (char c : key) {
+            h = h * 31 + static_cast<size_t>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return h;
+    }
+};
+
+struct CaseInsensitiveEqual {
+    bool operator()(const std::string& a, const std::string& b) const {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+            [](char x, char y) {
+                return std::tolower(static_cast<unsigned char>(x)) ==
+                       std::tolower(static_cast<unsigned char>(y));
+            });
+    }
+};
+
+TEST_F(SwissHashMapTest, CustomHashAndKeyEqual) {
+    SwissHashMap<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual> names;
+    names.put("Alice", 1);
+    names.put("ALICE", 2);
+    EXPECT_EQ(names.size(), 1u);
+    EXPECT_EQ(names.get("alice"), 2);
+    EXPECT_TRUE(names.remove("aLiCe"));
+    EXPECT_TRUE(names.empty());
+}
+
+TEST_F(SwissHashMapTest, TransparentLookup) {
+    map->put("alpha", "1");
+    map->put("gamma", "3");
+    std::string buffer = "tokens alpha beta gamma";
+    EXPECT_TRUE(map->contains(std::string_view(buffer).substr(7, 5)));
+    EXPECT_FALSE(map->contains(std::string_view(buffer).substr(13, 4)));
+    EXPECT_TRUE(map->contains(std::string_view(buffer).substr(18, 5)));
+}
+
+TEST_F(SwissHashMapTest, ReserveAndClear) {
+    map->reserve(1000);
+    size_t reserved = map->bucketCount();
+    for (int i = 0; i < 1000; i++) {
+        map->put("key" + std::to_string(i), "value");
+    }
+    EXPECT_EQ(map->bucketCount(), reserved);
+    map->clear();
+    EXPECT_TRUE(map->empty());
+    EXPECT_FALSE(map->contains("key1"));
+}
+
+TEST_F(SwissHashMapTest, ControlGroupMatch) {
+    int8_t group[ControlGroup::WIDTH];
+    for (size_t i = 0; i < ControlGroup::WIDTH; i++) {
+        group[i] = ControlGroup::EMPTY;
+    }
+    group[3] = 42;
+    group[9] = 42;
+    group[5] = ControlGroup::DELETED;
+    EXPECT_EQ(ControlGroup::match(group, 42), (1u << 3) | (1u << 9));
+    EXPECT_EQ(ControlGroup::matchEmptyOrDeleted(group), 0xFFFFu & ~((1u << 3) | (1u << 9)));
+    EXPECT_EQ(ControlGroup::matchEmpty(group), 0xFFFFu & ~((1u << 3) | (1u << 9) | (1u << 5)));
+    EXPECT_EQ(ControlGroup::lowestBit(ControlGroup::match(group, 42)), 3u);
+}
+
+TEST_F(SwissHashMapTest, Print) {
+    map->put("key1", "value1");
+    std::ostringstream oss;
+    map->print(oss);
+    EXPECT_NE(oss.str().find("key1"), std::string::npos);
+}